@@ -0,0 +1,216 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Host tool for pulse train capture logs (see src/PulseTrainCapture.h).
+
+  capture record [-i receiver] LOG
+    Append pulse trains given as pilight USB Nano strings on stdin
+    ("c:...;p:...@", one or more per line) to LOG.
+
+  capture replay [-s] [-v] [-n loops] [-l protocols] LOG
+    Push the recorded pulse trains through ESPiLight::parsePulseTrain(), as
+    fast as possible or with -s at recorded speed, and print statistics.
+    protocols is a json array as accepted by ESPiLight::limitProtocols().
+*/
+
+#include <ESPiLight.h>
+#include <PulseTrainCapture.h>
+#include <time.h>
+#include <unistd.h>
+
+static bool verbose = false;
+static size_t messages = 0;
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: capture record [-i receiver] LOG\n"
+          "       capture replay [-s] [-v] [-n loops] [-l protocols] LOG\n");
+  exit(EXIT_FAILURE);
+}
+
+static int record(int argc, char **argv) {
+  uint8_t receiver = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "i:")) != -1) {
+    switch (opt) {
+      case 'i':
+        receiver = (uint8_t)atoi(optarg);
+        break;
+      default:
+        usage();
+    }
+  }
+  if (optind + 1 != argc) {
+    usage();
+  }
+
+  FILE *file = fopen(argv[optind], "ab");
+  if (file == nullptr) {
+    perror(argv[optind]);
+    return EXIT_FAILURE;
+  }
+  FileStream output(file);
+  PulseTrainCaptureWriter writer(output, receiver);
+  if (ftell(file) == 0) {
+    writer.writeHeader();
+  }
+
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  PulseTrainStringParser parser(pulses, MAXPULSESTREAMLENGTH);
+  FileStream input(stdin);
+  size_t records = 0;
+  size_t invalid = 0;
+  int c;
+  while ((c = input.read()) >= 0) {
+    if (parser.parse((char)c)) {
+      writer.write(pulses, parser.length());
+      records++;
+    } else if (c == '@' && parser.error() != 0) {
+      invalid++;
+    }
+  }
+  fclose(file);
+  fprintf(stderr, "%zu records written, %zu invalid pulse trains\n", records,
+          invalid);
+  return EXIT_SUCCESS;
+}
+
+static int replay(int argc, char **argv) {
+  bool realtime = false;
+  unsigned long loops = 1;
+  const char *protocols = nullptr;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "svn:l:")) != -1) {
+    switch (opt) {
+      case 's':
+        realtime = true;
+        break;
+      case 'v':
+        verbose = true;
+        break;
+      case 'n':
+        loops = strtoul(optarg, nullptr, 10);
+        break;
+      case 'l':
+        protocols = optarg;
+        break;
+      default:
+        usage();
+    }
+  }
+  if (optind + 1 != argc) {
+    usage();
+  }
+
+  ESPiLight rf(-1);
+  rf.setCallback([](const String &protocol, const String &message, int status,
+                    size_t repeats, const String &deviceID) {
+    messages++;
+    if (verbose) {
+      printf("  [%s][%s] (%d, %zu) %s\n", protocol.c_str(), deviceID.c_str(),
+             status, repeats, message.c_str());
+    }
+  });
+  if (protocols != nullptr) {
+    ESPiLight::limitProtocols(protocols);
+  }
+
+  FILE *file = fopen(argv[optind], "rb");
+  if (file == nullptr) {
+    perror(argv[optind]);
+    return EXIT_FAILURE;
+  }
+  FileStream input(file);
+  static PulseTrainCaptureRecord_t rec;
+  size_t records = 0;
+  size_t pulses = 0;
+  size_t mismatches = 0;
+  uint64_t parse_ns = 0;
+
+  for (unsigned long loop = 0; loop < loops; loop++) {
+    PulseTrainCaptureReader reader(input);
+    rewind(file);
+    if (!reader.readHeader()) {
+      fprintf(stderr, "%s: not a capture log\n", argv[optind]);
+      return EXIT_FAILURE;
+    }
+    bool first = true;
+    uint32_t last = 0;
+    while (reader.read(&rec)) {
+      // an earlier timestamp means the log was continued after a restart
+      // (or micros() wrapped), do not wait in that case
+      if (realtime && !first && rec.timestamp >= last) {
+        usleep((useconds_t)(rec.timestamp - last));
+      }
+      first = false;
+      last = rec.timestamp;
+      // decoders use micros() for repeat detection, so use recorded time
+      host_set_micros(rec.timestamp);
+      if (verbose) {
+        printf("%lu: receiver %u, %u pulses\n", (unsigned long)rec.timestamp,
+               rec.receiver, rec.length);
+      }
+      const uint64_t start = now_ns();
+      const size_t matches = rf.parsePulseTrain(rec.pulses, rec.length);
+      parse_ns += now_ns() - start;
+      if (rec.matches != CAPTURE_MATCHES_UNKNOWN && rec.matches != matches) {
+        mismatches++;
+        if (verbose) {
+          printf("  decoded by %zu protocols, recorded %u\n", matches,
+                 rec.matches);
+        }
+      }
+      records++;
+      pulses += rec.length;
+    }
+  }
+  fclose(file);
+
+  printf("records:    %zu\n", records);
+  printf("pulses:     %zu\n", pulses);
+  printf("messages:   %zu\n", messages);
+  printf("mismatches: %zu\n", mismatches);
+  if (records > 0) {
+    printf("parse time: %.3f ms (%.2f us/record, %.0f records/s)\n",
+           (double)parse_ns / 1e6, (double)parse_ns / 1e3 / (double)records,
+           (double)records * 1e9 / (double)(parse_ns > 0 ? parse_ns : 1));
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+  }
+  if (strcmp(argv[1], "record") == 0) {
+    return record(argc - 1, argv + 1);
+  }
+  if (strcmp(argv[1], "replay") == 0) {
+    return replay(argc - 1, argv + 1);
+  }
+  usage();
+}
@@ -0,0 +1,215 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Host harness for ESPiLight::parsePulseTrain().
+
+  decode [-e expected] TRAINS
+    Decode the pulse trains of TRAINS (one per line, pulse lengths in us,
+    whitespace separated, '#' starts a comment) with all protocols. The
+    decoded messages are printed as "train protocol message", one per line,
+    or compared to the lines of the expected file.
+
+  decode -g
+    Create pulse trains from "protocol json" lines on stdin: for each line
+    the pulse train of the encoder, JITTERED copies with pulse lengths off
+    by up to 25 % and RANDOMIZED copies with each pulse drawn at random from
+    the train, keeping the footer. The output is repeatable, e.g. to create a
+    corpus whose expected messages are recorded with another version of the
+    decoders.
+*/
+
+#include <ESPiLight.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#define JITTERED 3
+#define RANDOMIZED 3
+
+static void usage() {
+  fprintf(stderr,
+          "usage: decode [-e expected] TRAINS\n"
+          "       decode -g\n");
+  exit(EXIT_FAILURE);
+}
+
+static void print_train(const uint16_t *pulses, int length) {
+  for (int i = 0; i < length; i++) {
+    printf(i > 0 ? " %u" : "%u", pulses[i]);
+  }
+  printf("\n");
+}
+
+static int generate() {
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  uint16_t copy[MAXPULSESTREAMLENGTH];
+  char line[256];
+
+  srand(1);
+  while (fgets(line, sizeof(line), stdin) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char *json = strchr(line, ' ');
+    if (line[0] == '#' || json == nullptr) {
+      continue;
+    }
+    *json++ = '\0';
+    int length = ESPiLight::createPulseTrain(pulses, line, json);
+    if (length <= 0) {
+      fprintf(stderr, "%s %s: error %d\n", line, json, length);
+      return EXIT_FAILURE;
+    }
+    printf("# %s %s\n", line, json);
+    print_train(pulses, length);
+    for (int k = 0; k < JITTERED; k++) {
+      for (int i = 0; i < length; i++) {
+        copy[i] = pulses[i] * (75 + rand() % 51) / 100;
+      }
+      print_train(copy, length);
+    }
+    for (int k = 0; k < RANDOMIZED; k++) {
+      for (int i = 0; i < length - 1; i++) {
+        copy[i] = pulses[rand() % (length - 1)];
+      }
+      copy[length - 1] = pulses[length - 1];
+      print_train(copy, length);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+static bool read_trains(const char *path,
+                        std::vector<std::vector<uint16_t>> *trains) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  static char line[8 * MAXPULSESTREAMLENGTH];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    std::vector<uint16_t> train;
+    char *token = strtok(line, " \t\r\n");
+    while (token != nullptr && token[0] != '#') {
+      train.push_back(strtoul(token, nullptr, 10));
+      token = strtok(nullptr, " \t\r\n");
+    }
+    if (train.size() > MAXPULSESTREAMLENGTH) {
+      fprintf(stderr, "%s: pulse train %zu too long\n", path,
+              trains->size() + 1);
+      fclose(file);
+      return false;
+    }
+    if (!train.empty()) {
+      trains->push_back(train);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+static int verify(ESPiLight *rf,
+                  const std::vector<std::vector<uint16_t>> &trains,
+                  const char *expected_path) {
+  std::vector<std::string> messages;
+  size_t number = 0;
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+
+  rf->setCallback([&](const String &protocol, const String &message, int,
+                      size_t, const String &) {
+    messages.push_back(std::to_string(number) + " " + protocol.c_str() + " " +
+                       message.c_str());
+  });
+  for (const std::vector<uint16_t> &train : trains) {
+    number++;
+    // the decoders may modify the pulses
+    memcpy(pulses, train.data(), train.size() * sizeof(uint16_t));
+    rf->parsePulseTrain(pulses, (uint8_t)train.size());
+  }
+
+  if (expected_path == nullptr) {
+    for (const std::string &message : messages) {
+      printf("%s\n", message.c_str());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  FILE *file = fopen(expected_path, "r");
+  if (file == nullptr) {
+    perror(expected_path);
+    return EXIT_FAILURE;
+  }
+  size_t count = 0;
+  int result = EXIT_SUCCESS;
+  char line[1024];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (count >= messages.size()) {
+      fprintf(stderr, "message %zu missing: %s\n", count + 1, line);
+      result = EXIT_FAILURE;
+    } else if (messages[count] != line) {
+      fprintf(stderr, "message %zu differs:\n  expected: %s\n  got:      %s\n",
+              count + 1, line, messages[count].c_str());
+      result = EXIT_FAILURE;
+    }
+    count++;
+  }
+  fclose(file);
+  for (; count < messages.size(); count++) {
+    fprintf(stderr, "unexpected message %zu: %s\n", count + 1,
+            messages[count].c_str());
+    result = EXIT_FAILURE;
+  }
+  fprintf(stderr, "%zu messages of %zu pulse trains %s\n", messages.size(),
+          trains.size(),
+          result == EXIT_SUCCESS ? "as expected" : "NOT as expected");
+  return result;
+}
+
+int main(int argc, char **argv) {
+  const char *expected = nullptr;
+  bool generator = false;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "ge:")) != -1) {
+    switch (opt) {
+      case 'g':
+        generator = true;
+        break;
+      case 'e':
+        expected = optarg;
+        break;
+      default:
+        usage();
+    }
+  }
+
+  // the constructor initializes the protocols
+  ESPiLight rf(-1);
+
+  if (generator) {
+    return generate();
+  }
+  if (optind + 1 != argc) {
+    usage();
+  }
+  std::vector<std::vector<uint16_t>> trains;
+  if (!read_trains(argv[optind], &trains)) {
+    return EXIT_FAILURE;
+  }
+  return verify(&rf, trains, expected);
+}
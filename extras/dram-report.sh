@@ -0,0 +1,59 @@
+#!/bin/sh
+# ESPiLight - pilight 433.92 MHz protocols library for Arduino
+# Copyright (c) 2016 Puuu.  All right reserved.
+#
+# Project home: https://github.com/puuu/espilight/
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 3 of the License, or (at your option) any later version.
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with library. If not, see <http://www.gnu.org/licenses/>
+
+# Static DRAM used by the library in an ESP8266 firmware, per source file.
+#
+# usage: dram-report.sh [-s] FIRMWARE.elf
+#   -s  list the symbols instead of the files
+#
+# The firmware has to be built with debug info (the Arduino IDE and
+# PlatformIO do). NM selects the nm of the toolchain, default
+# xtensa-lx106-elf-nm. Counted are data, bss and rodata, which all live in
+# DRAM on the ESP8266; PROGMEM tables and PSTR() strings are in flash.
+
+set -e
+
+SYMBOLS=0
+if [ "$1" = "-s" ]; then
+  SYMBOLS=1
+  shift
+fi
+if [ $# -ne 1 ]; then
+  echo "usage: $0 [-s] FIRMWARE.elf" >&2
+  exit 1
+fi
+
+${NM:-xtensa-lx106-elf-nm} -S -t d -l --defined-only "$1" | awk -v symbols=$SYMBOLS '
+  NF >= 5 && $3 ~ /^[bBdDrR]$/ &&
+  $NF ~ /\/src\/(ESPiLight|PulseTrainCapture|pilight\/|tools\/)/ {
+    file = $NF
+    sub(/:[0-9]+$/, "", file)
+    sub(/.*\/src\//, "", file)
+    size = $2 + 0
+    total += size
+    if (symbols) {
+      printf "%8d  %s (%s)\n", size, $4, file
+    } else {
+      bytes[file] += size
+    }
+  }
+  END {
+    for (file in bytes) {
+      printf "%8d  %s\n", bytes[file], file
+    }
+    printf "%8d  total\n", total
+  }' | sort -n
@@ -0,0 +1,234 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Minimal host (Linux) implementation of the Arduino API used by ESPiLight.
+  It allows to build the library and its tools with a native compiler, it
+  is not meant to be complete.
+*/
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "pgmspace.h"
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define CHANGE 0x3
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((int)(p))
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define F(s) (s)
+#define FPSTR(p) (p)
+
+// ESP.getCycleCount() counts ns on the host
+#define clockCyclesPerMicrosecond() 1000L
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+/**
+ * Host only: replace the clock of micros() and millis() by a clock that only
+ * advances by host_set_micros(). Used to replay recorded signals.
+ */
+void host_set_micros(unsigned long now);
+
+class String {
+ public:
+  String() {}
+  String(const char *cstr) : _buffer(cstr != nullptr ? cstr : "") {}
+  String(const String &str) = default;
+  explicit String(char c) : _buffer(1, c) {}
+  explicit String(int value) : _buffer(std::to_string(value)) {}
+  explicit String(unsigned int value) : _buffer(std::to_string(value)) {}
+  explicit String(long value) : _buffer(std::to_string(value)) {}
+  explicit String(unsigned long value) : _buffer(std::to_string(value)) {}
+  String &operator=(const String &rhs) = default;
+
+  const char *c_str() const { return _buffer.c_str(); }
+  unsigned int length() const { return (unsigned int)_buffer.size(); }
+  bool reserve(unsigned int size) {
+    _buffer.reserve(size);
+    return true;
+  }
+  bool concat(const char *cstr, unsigned int length) {
+    _buffer.append(cstr, length);
+    return true;
+  }
+
+  String &operator+=(const String &rhs) {
+    _buffer += rhs._buffer;
+    return *this;
+  }
+  String &operator+=(const char *cstr) {
+    _buffer += cstr;
+    return *this;
+  }
+  String &operator+=(char c) {
+    _buffer += c;
+    return *this;
+  }
+  String &operator+=(int value) { return *this += String(value); }
+  String &operator+=(unsigned int value) { return *this += String(value); }
+  String &operator+=(long value) { return *this += String(value); }
+  String &operator+=(unsigned long value) { return *this += String(value); }
+
+  char operator[](unsigned int index) const {
+    return index < _buffer.size() ? _buffer[index] : '\0';
+  }
+  bool operator==(const String &rhs) const { return _buffer == rhs._buffer; }
+  bool operator==(const char *cstr) const { return _buffer == cstr; }
+  bool operator!=(const String &rhs) const { return _buffer != rhs._buffer; }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t pos = _buffer.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    return String(_buffer.substr(from, to - from).c_str());
+  }
+  long toInt() const { return atol(_buffer.c_str()); }
+
+ private:
+  std::string _buffer;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size-- > 0) {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+  size_t write(const char *str) {
+    return write((const uint8_t *)str, strlen(str));
+  }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(const String &str) { return write(str.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return print(String(value)); }
+  size_t print(unsigned int value) { return print(String(value)); }
+  size_t print(long value) { return print(String(value)); }
+  size_t print(unsigned long value) { return print(String(value)); }
+  size_t print(double value, int digits = 2) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return print(buffer);
+  }
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(uint8_t *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0) {
+        break;
+      }
+      buffer[count++] = (uint8_t)c;
+    }
+    return count;
+  }
+  size_t readBytes(char *buffer, size_t length) {
+    return readBytes((uint8_t *)buffer, length);
+  }
+};
+
+/**
+ * Stream on top of a stdio FILE.
+ */
+class FileStream : public Stream {
+ public:
+  explicit FileStream(FILE *file) : _file(file) {}
+  size_t write(uint8_t c) override { return fputc(c, _file) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    return fwrite(buffer, 1, size, _file);
+  }
+  int available() override { return peek() < 0 ? 0 : 1; }
+  int read() override { return fgetc(_file); }
+  int peek() override {
+    int c = fgetc(_file);
+    if (c != EOF) {
+      ungetc(c, _file);
+    }
+    return c;
+  }
+
+ private:
+  FILE *_file;
+};
+
+class HardwareSerial : public FileStream {
+ public:
+  HardwareSerial() : FileStream(stdout) {}
+  void begin(unsigned long baud) { (void)baud; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+ public:
+  void restart() { abort(); }
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getCycleCount();
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,2 @@
+// Host (Linux) replacement, everything is declared in Arduino.h.
+#include "Arduino.h"
@@ -0,0 +1,104 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <time.h>
+#include "../../src/tools/aprintf.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static bool host_fake_clock = false;
+static unsigned long host_now = 0;
+
+static uint64_t monotonic_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static const uint64_t host_start = monotonic_ns();
+
+void host_set_micros(unsigned long now) {
+  host_fake_clock = true;
+  host_now = now;
+}
+
+unsigned long micros() {
+  if (host_fake_clock) {
+    return host_now;
+  }
+  return (unsigned long)((monotonic_ns() - host_start) / 1000);
+}
+
+unsigned long millis() { return micros() / 1000; }
+
+// the fake clock advances, so waiting loops terminate
+void delay(unsigned long ms) {
+  if (host_fake_clock) {
+    host_now += ms * 1000;
+  }
+}
+
+void delayMicroseconds(unsigned int us) { (void)us; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  (void)pin;
+  (void)val;
+}
+
+int digitalRead(uint8_t pin) {
+  (void)pin;
+  return LOW;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode) {
+  (void)interrupt;
+  (void)handler;
+  (void)mode;
+}
+
+void detachInterrupt(uint8_t interrupt) { (void)interrupt; }
+
+void noInterrupts() {}
+
+void interrupts() {}
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)monotonic_ns(); }
+
+// replacement of src/tools/aprintf.cpp, pilight messages go to stderr
+static Print *aprintf_print = nullptr;
+
+void set_aprintf_output(Print *output) { aprintf_print = output; }
+
+int aprintf_P(PGM_P formatP, ...) {
+  if (aprintf_print == nullptr) {
+    return 0;
+  }
+  va_list arg;
+  va_start(arg, formatP);
+  int len = vfprintf(stderr, formatP, arg);
+  va_end(arg);
+  return len;
+}
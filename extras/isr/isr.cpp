@@ -0,0 +1,243 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Host harness for ESPiLight::interruptHandler().
+
+  isr [-e expected] [-n loops] EDGES
+    Feed the edge timestamps (us, whitespace separated, '#' starts a
+    comment) of EDGES to interruptHandler() with a mocked micros(). The
+    received pulse trains are printed, one per line, or compared to the
+    lines of the expected file, followed by the receiver statistics if
+    built with RECEIVER_STATS=1. Afterwards the edges are replayed loops
+    times (default 100) to measure the time per edge.
+
+  isr -g
+    Convert pilight USB Nano strings on stdin ("c:...;p:...;r:...@") into
+    edge timestamps, e.g. to create input for the harness.
+*/
+
+#include <ESPiLight.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#define RECEIVER_PIN 0
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: isr [-e expected] [-n loops] EDGES\n"
+          "       isr -g\n");
+  exit(EXIT_FAILURE);
+}
+
+static int generate() {
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  PulseTrainStringParser parser(pulses, MAXPULSESTREAMLENGTH);
+  FileStream input(stdin);
+  // start with a long gap, so the first edge is not taken as pulse
+  unsigned long timestamp = 100000;
+  int c;
+
+  printf("%lu\n", timestamp);
+  while ((c = input.read()) >= 0) {
+    if (!parser.parse((char)c)) {
+      continue;
+    }
+    int repeats = parser.repeats() > 0 ? parser.repeats() : 1;
+    for (int r = 0; r < repeats; r++) {
+      for (size_t i = 0; i < parser.length(); i++) {
+        timestamp += pulses[i];
+        printf("%lu\n", timestamp);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+static bool read_edges(const char *path, std::vector<unsigned long> *edges) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    char *token = strtok(line, " \t\r\n");
+    while (token != nullptr && token[0] != '#') {
+      edges->push_back(strtoul(token, nullptr, 10));
+      token = strtok(nullptr, " \t\r\n");
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+static std::string drain_pulse_train() {
+  std::string train;
+  uint8_t length = 0;
+  const uint16_t *pulses = ESPiLight::borrowPulseTrain(&length);
+
+  for (uint8_t i = 0; i < length; i++) {
+    if (i > 0) {
+      train += ' ';
+    }
+    train += std::to_string(pulses[i]);
+  }
+  ESPiLight::releasePulseTrain();
+  return train;
+}
+
+static int verify(const std::vector<unsigned long> &edges,
+                  const char *expected_path) {
+  std::vector<std::string> trains;
+
+  for (unsigned long edge : edges) {
+    host_set_micros(edge);
+    ESPiLight::interruptHandler();
+    if (ESPiLight::nextPulseTrainLength() > 0) {
+      trains.push_back(drain_pulse_train());
+    }
+  }
+
+  if (expected_path == nullptr) {
+    for (const std::string &train : trains) {
+      printf("%s\n", train.c_str());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  FILE *file = fopen(expected_path, "r");
+  if (file == nullptr) {
+    perror(expected_path);
+    return EXIT_FAILURE;
+  }
+  size_t count = 0;
+  int result = EXIT_SUCCESS;
+  static char line[8 * MAXPULSESTREAMLENGTH];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (count >= trains.size()) {
+      fprintf(stderr, "pulse train %zu missing: %s\n", count + 1, line);
+      result = EXIT_FAILURE;
+    } else if (trains[count] != line) {
+      fprintf(stderr, "pulse train %zu differs:\n  expected: %s\n  got:      %s\n",
+              count + 1, line, trains[count].c_str());
+      result = EXIT_FAILURE;
+    }
+    count++;
+  }
+  fclose(file);
+  for (; count < trains.size(); count++) {
+    fprintf(stderr, "unexpected pulse train %zu: %s\n", count + 1,
+            trains[count].c_str());
+    result = EXIT_FAILURE;
+  }
+  fprintf(stderr, "%zu pulse trains %s\n", trains.size(),
+          result == EXIT_SUCCESS ? "as expected" : "NOT as expected");
+  return result;
+}
+
+static void print_receiver_stats() {
+  ReceiverStats_t stats;
+  if (!ESPiLight::receiverStats(&stats)) {
+    return;
+  }
+  fprintf(stderr, "receiver stats: %u edges, %u below min, %u above max, "
+          "%u overruns\n", stats.edges, stats.belowMinPulse,
+          stats.aboveMaxPulse, stats.overruns);
+  for (unsigned int i = 0; i < RECEIVER_STATS_BUCKETS; i++) {
+    if (stats.histogram[i] > 0) {
+      fprintf(stderr, "  %6u us: %u\n", 1U << i, stats.histogram[i]);
+    }
+  }
+}
+
+static void benchmark(const std::vector<unsigned long> &edges,
+                      unsigned long loops) {
+  if (edges.size() < 2 || loops == 0) {
+    return;
+  }
+  // each loop continues in time, so pulse lengths stay the same
+  const unsigned long period = edges.back() - edges.front() + 100000;
+  size_t trains = 0;
+  uint64_t elapsed = 0;
+
+  for (unsigned long loop = 1; loop <= loops; loop++) {
+    const unsigned long offset = loop * period;
+    const uint64_t start = now_ns();
+    for (unsigned long edge : edges) {
+      host_set_micros(edge + offset);
+      ESPiLight::interruptHandler();
+      // keep the queue free, like loop() would
+      if (ESPiLight::nextPulseTrainLength() > 0) {
+        ESPiLight::releasePulseTrain();
+        trains++;
+      }
+    }
+    elapsed += now_ns() - start;
+  }
+  const double count = (double)edges.size() * (double)loops;
+  fprintf(stderr, "%.0f edges, %zu pulse trains, %.1f ns/edge\n", count,
+          trains, (double)elapsed / count);
+}
+
+int main(int argc, char **argv) {
+  const char *expected = nullptr;
+  unsigned long loops = 100;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "ge:n:")) != -1) {
+    switch (opt) {
+      case 'g':
+        return generate();
+      case 'e':
+        expected = optarg;
+        break;
+      case 'n':
+        loops = strtoul(optarg, nullptr, 10);
+        break;
+      default:
+        usage();
+    }
+  }
+  if (optind + 1 != argc) {
+    usage();
+  }
+
+  std::vector<unsigned long> edges;
+  if (!read_edges(argv[optind], &edges)) {
+    return EXIT_FAILURE;
+  }
+
+  // the constructor initializes the protocols and the receiver limits
+  ESPiLight rf(-1);
+  ESPiLight::initReceiver(RECEIVER_PIN);
+
+  int result = verify(edges, expected);
+  print_receiver_stats();
+  benchmark(edges, loops);
+  return result;
+}
@@ -0,0 +1,115 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Check of the listen before talk deferral.
+
+  lbt
+    Feed edges to interruptHandler() with a mocked micros() and send a
+    pulse train right after each case: isolated noise must not defer the
+    transmission, a pulse train being received or just received must.
+*/
+
+#include <ESPiLight.h>
+
+#define RECEIVER_PIN 0
+#define TRANSMITTER_PIN 1
+#define QUIET 5000  // us
+
+static unsigned long timestamp = 0;
+
+static void edge(unsigned long after) {
+  timestamp += after;
+  host_set_micros(timestamp);
+  ESPiLight::interruptHandler();
+}
+
+// an idle channel: no edge for a second, then the first edge
+static void idle() { edge(1000000); }
+
+static bool deferred(ESPiLight *rf) {
+  static const uint16_t pulses[] = {300, 900, 300, 10200};
+  TransmitStats_t before, after;
+
+  rf->transmitStats(&before);
+  rf->sendPulseTrain(pulses, sizeof(pulses) / sizeof(pulses[0]), 1);
+  rf->transmitStats(&after);
+  // the transmission continues the mocked time
+  timestamp = micros();
+  return after.deferred != before.deferred;
+}
+
+static int check(ESPiLight *rf, const char *name, bool expected) {
+  bool got = deferred(rf);
+  if (got != expected) {
+    fprintf(stderr, "%s: %s, expected %s\n", name,
+            got ? "deferred" : "not deferred",
+            expected ? "deferred" : "not deferred");
+    return 1;
+  }
+  return 0;
+}
+
+int main() {
+  uint16_t train[MAXPULSESTREAMLENGTH];
+  int length = ESPiLight::createPulseTrain(
+      train, "arctech_switch", "{\"id\":1234567,\"unit\":3,\"on\":1}");
+  int failures = 0;
+  int cases = 0;
+
+  ESPiLight rf(TRANSMITTER_PIN);
+  ESPiLight::initReceiver(RECEIVER_PIN);
+  rf.setListenBeforeTalk(QUIET);
+
+  idle();
+  failures += check(&rf, "noise edge after start", false);
+  cases++;
+
+  idle();
+  for (int i = 0; i < length; i++) {
+    edge(train[i]);
+  }
+  if (ESPiLight::nextPulseTrainLength() != length) {
+    fprintf(stderr, "pulse train not received\n");
+    return EXIT_FAILURE;
+  }
+  ESPiLight::releasePulseTrain();
+  failures += check(&rf, "footer of a pulse train", true);
+  cases++;
+
+  idle();
+  failures += check(&rf, "noise edge after a pulse train", false);
+  cases++;
+
+  idle();
+  edge(400);
+  edge(250);
+  failures += check(&rf, "noise burst", false);
+  cases++;
+
+  idle();
+  for (int i = 0; i < 10; i++) {
+    edge(train[i]);
+  }
+  failures += check(&rf, "pulse train in progress", true);
+  cases++;
+
+  fprintf(stderr, "%d listen before talk cases %s\n", cases,
+          failures == 0 ? "as expected" : "NOT as expected");
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Check and benchmark of pulsecodePack().
+
+  pulsecode [-n loops]
+    Compare pulsecodePack() to a plain loop on random pulses, strides and
+    thresholds, then time both on loops (default 20) passes over one
+    million pulses of random switch telegrams, for strides 1, 2 and 4.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "pilight/libs/pilight/core/pulsecode.h"
+}
+
+#define TRAFFIC_PULSES 1000000
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: pulsecode [-n loops]\n");
+  exit(EXIT_FAILURE);
+}
+
+static const char *kernel_name() {
+  switch (PULSECODE_KERNEL) {
+    case PULSECODE_SWAR:
+      return "swar";
+    case PULSECODE_SSE2:
+      return "sse2";
+    case PULSECODE_NEON:
+      return "neon";
+    default:
+      return "scalar";
+  }
+}
+
+static int reference_pack(const uint16_t *raw, int n, int stride,
+                          uint16_t threshold, uint32_t *bits) {
+  int words = (n + 31) / 32;
+  memset(bits, 0, words * sizeof(uint32_t));
+  for (int i = 0; i < n; i++) {
+    if (raw[i * stride] > threshold) {
+      bits[i / 32] |= 1U << (i % 32);
+    }
+  }
+  return words;
+}
+
+static uint16_t random_pulse() {
+  switch (rand() % 4) {
+    case 0:  // around the sign bit of the vector compare
+      return 0x7ff0 + rand() % 0x20;
+    case 1:  // range limits
+      return (rand() & 1) ? 0 : 0xffff;
+    default:
+      return rand() & 0xffff;
+  }
+}
+
+static int verify() {
+  std::vector<uint16_t> raw(1024);
+  uint32_t expected[64], got[64];
+  int failures = 0;
+
+  srand(1);
+  for (int k = 0; k < 200000; k++) {
+    int stride = 1 + rand() % 5;
+    // unaligned start, like raw+header+pulse
+    int offset = rand() % 4;
+    int n = rand() % ((raw.size() - offset - 1) / stride + 2);
+    uint16_t threshold = (k % 8 == 0) ? (rand() & 1) * 0xffff : random_pulse();
+    for (size_t i = 0; i < raw.size(); i++) {
+      raw[i] = random_pulse();
+    }
+    int words = reference_pack(&raw[offset], n, stride, threshold, expected);
+    int got_words = pulsecodePack(&raw[offset], n, stride, threshold, got);
+    if (got_words != words ||
+        memcmp(got, expected, words * sizeof(uint32_t)) != 0) {
+      if (failures++ < 10) {
+        fprintf(stderr, "mismatch: n %d, stride %d, threshold %u\n", n,
+                stride, threshold);
+      }
+    }
+  }
+  fprintf(stderr, "%s kernel %s\n", kernel_name(),
+          failures == 0 ? "matches" : "DOES NOT match");
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void benchmark(unsigned long loops) {
+  if (loops == 0) {
+    return;
+  }
+  // back to back telegrams of 300 us short and 900 us long pulses
+  std::vector<uint16_t> raw(TRAFFIC_PULSES);
+  for (size_t i = 0; i < raw.size(); i++) {
+    raw[i] = (rand() & 1) ? 900 : 300;
+  }
+  std::vector<uint32_t> bits(raw.size() / 32 + 1);
+  static const int strides[] = {1, 2, 4};
+
+  for (int stride : strides) {
+    int n = (raw.size() - 1) / stride + 1;
+    uint64_t elapsed[2] = {0, 0};
+    uint32_t sum = 0;
+    for (unsigned long loop = 0; loop < loops; loop++) {
+      uint64_t start = now_ns();
+      reference_pack(raw.data(), n, stride, 600, bits.data());
+      elapsed[0] += now_ns() - start;
+      sum += bits[loop % bits.size()];
+      start = now_ns();
+      pulsecodePack(raw.data(), n, stride, 600, bits.data());
+      elapsed[1] += now_ns() - start;
+      sum += bits[loop % bits.size()];
+    }
+    double pulses = (double)n * loops;
+    printf("stride %d: loop %.2f ns/pulse, %s %.2f ns/pulse (%08x)\n", stride,
+           elapsed[0] / pulses, kernel_name(), elapsed[1] / pulses, sum);
+  }
+}
+
+int main(int argc, char **argv) {
+  unsigned long loops = 20;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:")) != -1) {
+    switch (opt) {
+      case 'n':
+        loops = strtoul(optarg, nullptr, 10);
+        break;
+      default:
+        usage();
+    }
+  }
+  if (optind != argc) {
+    usage();
+  }
+
+  int result = verify();
+  benchmark(loops);
+  return result;
+}
@@ -0,0 +1,148 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+/*
+  Round trip of the encoders through the decoders.
+
+  roundtrip [-e expected] COMMANDS
+    Create the pulse train of each "protocol json" line of COMMANDS ('#'
+    starts a comment) with createPulseTrain() and decode it with
+    parsePulseTrain(). The messages decoded by the same protocol are printed
+    as "protocol message", one per line, or "protocol -" if there is none,
+    or compared to the lines of the expected file.
+*/
+
+#include <ESPiLight.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+static void usage() {
+  fprintf(stderr, "usage: roundtrip [-e expected] COMMANDS\n");
+  exit(EXIT_FAILURE);
+}
+
+static bool round_trip(ESPiLight *rf, const char *path,
+                       std::vector<std::string> *results) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  std::string protocol;
+  std::vector<std::string> messages;
+  char line[256];
+
+  rf->setCallback([&](const String &decoder, const String &message, int,
+                      size_t, const String &) {
+    if (protocol == decoder.c_str()) {
+      messages.push_back(protocol + " " + message.c_str());
+    }
+  });
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char *json = strchr(line, ' ');
+    if (line[0] == '#' || json == nullptr) {
+      continue;
+    }
+    *json++ = '\0';
+    protocol = line;
+    messages.clear();
+    int length = ESPiLight::createPulseTrain(pulses, line, json);
+    if (length <= 0) {
+      fprintf(stderr, "%s %s: error %d\n", line, json, length);
+      fclose(file);
+      return false;
+    }
+    rf->parsePulseTrain(pulses, (uint8_t)length);
+    if (messages.empty()) {
+      messages.push_back(protocol + " -");
+    }
+    results->insert(results->end(), messages.begin(), messages.end());
+  }
+  fclose(file);
+  return true;
+}
+
+static int verify(const std::vector<std::string> &results,
+                  const char *expected_path) {
+  if (expected_path == nullptr) {
+    for (const std::string &result : results) {
+      printf("%s\n", result.c_str());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  FILE *file = fopen(expected_path, "r");
+  if (file == nullptr) {
+    perror(expected_path);
+    return EXIT_FAILURE;
+  }
+  size_t count = 0;
+  int result = EXIT_SUCCESS;
+  char line[1024];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (count >= results.size()) {
+      fprintf(stderr, "message %zu missing: %s\n", count + 1, line);
+      result = EXIT_FAILURE;
+    } else if (results[count] != line) {
+      fprintf(stderr, "message %zu differs:\n  expected: %s\n  got:      %s\n",
+              count + 1, line, results[count].c_str());
+      result = EXIT_FAILURE;
+    }
+    count++;
+  }
+  fclose(file);
+  for (; count < results.size(); count++) {
+    fprintf(stderr, "unexpected message %zu: %s\n", count + 1,
+            results[count].c_str());
+    result = EXIT_FAILURE;
+  }
+  fprintf(stderr, "%zu round trip messages %s\n", results.size(),
+          result == EXIT_SUCCESS ? "as expected" : "NOT as expected");
+  return result;
+}
+
+int main(int argc, char **argv) {
+  const char *expected = nullptr;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "e:")) != -1) {
+    switch (opt) {
+      case 'e':
+        expected = optarg;
+        break;
+      default:
+        usage();
+    }
+  }
+  if (optind + 1 != argc) {
+    usage();
+  }
+
+  // the constructor initializes the protocols
+  ESPiLight rf(-1);
+  std::vector<std::string> results;
+
+  if (!round_trip(&rf, argv[optind], &results)) {
+    return EXIT_FAILURE;
+  }
+  return verify(results, expected);
+}
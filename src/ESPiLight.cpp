@@ -18,6 +18,7 @@
 
 #include <ESPiLight.h>
 #include "tools/aprintf.h"
+#include "tools/memtrack.h"
 
 // ESP32 doesn't define ICACHE_RAM_ATTR
 #ifndef ICACHE_RAM_ATTR
@@ -33,8 +34,46 @@
 #endif
 
 extern "C" {
+#include "pilight/libs/pilight/core/msgpack.h"
 #include "pilight/libs/pilight/protocols/protocol.h"
 }
+
+#if MEMORY_STATS
+static MemoryStats_t memory_stats[MEMORY_STATS_OPERATIONS];
+
+/* accounts the heap usage during its lifetime to an operation */
+class MemoryStatsScope {
+ public:
+  explicit MemoryStatsScope(MemoryStatsOperation_t operation)
+      : _stats(memory_stats[operation]), _start(memtrack_stats) {
+    memtrack_stats.peak = memtrack_stats.current;
+  }
+
+  ~MemoryStatsScope() {
+    const memtrack_stats_t &end = memtrack_stats;
+    _stats.calls++;
+    _stats.allocations += end.allocations - _start.allocations;
+    _stats.frees += end.frees - _start.frees;
+    _stats.bytes += end.bytes - _start.bytes;
+    if (end.peak - _start.current > _stats.peak) {
+      _stats.peak = end.peak - _start.current;
+    }
+    _stats.retained += (int32_t)(end.current - _start.current);
+    if (_start.peak > memtrack_stats.peak) {
+      memtrack_stats.peak = _start.peak;
+    }
+  }
+
+ private:
+  MemoryStats_t &_stats;
+  const memtrack_stats_t _start;
+};
+
+#define MEMORY_STATS_SCOPE(operation) \
+  MemoryStatsScope memory_stats_scope(operation)
+#else
+#define MEMORY_STATS_SCOPE(operation)
+#endif
 static protocols_t *used_protocols = nullptr;
 
 volatile PulseTrain_t ESPiLight::_pulseTrains[RECEIVER_BUFFER_SIZE];
@@ -44,7 +83,11 @@ uint8_t ESPiLight::_avaiablePulseTrain = 0;
 volatile unsigned long ESPiLight::_lastChange =
     0;  // Timestamp of previous edge
 volatile uint8_t ESPiLight::_nrpulses = 0;
+volatile unsigned long ESPiLight::_lastTrain = 0;
 int16_t ESPiLight::_interrupt = NOT_AN_INTERRUPT;
+#if RECEIVER_STATS
+volatile ReceiverStats_t ESPiLight::_receiverStats;
+#endif
 
 uint8_t ESPiLight::minrawlen = std::numeric_limits<uint8_t>::max();
 uint8_t ESPiLight::maxrawlen = std::numeric_limits<uint8_t>::min();
@@ -53,7 +96,11 @@ uint16_t ESPiLight::maxgaplen = std::numeric_limits<uint16_t>::min();
 uint16_t ESPiLight::minpulselen = 80;
 uint16_t ESPiLight::maxpulselen = 16000;
 
-static void fire_callback(protocol_t *protocol, ESPiLightCallBack callback);
+static_assert(PULSETRAIN_CACHE_SIZE > 0, "PULSETRAIN_CACHE_SIZE must be > 0");
+
+static void fire_callback(protocol_t *protocol, ESPiLightCallBack callback,
+                          PilightMessageCallBack messageCallback,
+                          ESPiLightCStringCallBack cstringCallback);
 static void calc_lengths();
 
 static protocols_t *get_protocols() {
@@ -75,7 +122,7 @@ static protocols_t *get_used_protocols() {
 static protocols_t *find_protocol_node(const char *name) {
   protocols_t *pnode = get_protocols();
   while (pnode != nullptr) {
-    if (strcmp(name, pnode->listener->id) == 0) {
+    if (strcmp_P(name, pnode->listener->id) == 0) {
       return pnode;
     }
     pnode = pnode->next;
@@ -91,29 +138,56 @@ static protocol_t *find_protocol(const char *name) {
   return nullptr;
 }
 
+/*
+ * createCode() only looks up members of the command object, so an object
+ * on the stack referencing the parameters is sufficient.
+ */
+static JsonNode *params_to_json(const PilightParam_t *params, size_t count,
+                                JsonNode *nodes) {
+  JsonNode *object = &nodes[0];
+
+  memset(nodes, 0, (count + 1) * sizeof(JsonNode));
+  object->tag = JSON_OBJECT;
+  for (size_t i = 0; i < count; i++) {
+    JsonNode *node = &nodes[i + 1];
+    node->parent = object;
+    // interned keys hit the pointer compare in json_find_member()
+    const char *key = json_intern_key(params[i].key);
+    node->key = const_cast<char *>(key != nullptr ? key : params[i].key);
+    node->key_interned_ = true;
+    if (params[i].string != nullptr) {
+      node->tag = JSON_STRING;
+      node->string_ = const_cast<char *>(params[i].string);
+    } else {
+      node->tag = JSON_NUMBER;
+      node->number_ = params[i].number;
+    }
+    node->prev = object->children.tail;
+    if (node->prev != nullptr) {
+      node->prev->next = node;
+    } else {
+      object->children.head = node;
+    }
+    object->children.tail = node;
+  }
+  return object;
+}
+
 static int create_pulse_train(uint16_t *pulses, protocol_t *protocol,
-                              const String &content) {
+                              JsonNode *code) {
   Debug("piLightCreatePulseTrain: ");
 
-  if (!json_validate(content.c_str())) {
-    Debug("invalid json: ");
-    DebugLn(content);
-    return ESPiLight::ERROR_INVALID_JSON;
-  }
-
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wtype-limits"
   if ((protocol != nullptr) && (protocol->createCode != nullptr) &&
       (protocol->maxrawlen <= MAXPULSESTREAMLENGTH)) {
 #pragma GCC diagnostic pop
     Debug("protocol: ");
-    Debug(protocol->id);
+    Debug(FPSTR(protocol->id));
 
     protocol->rawlen = 0;
     protocol->raw = pulses;
-    JsonNode *message = json_decode(content.c_str());
-    int return_value = protocol->createCode(message);
-    json_delete(message);
+    int return_value = protocol->createCode(code);
     // delete message created by createCode()
     json_delete(protocol->message);
     protocol->message = nullptr;
@@ -129,6 +203,128 @@ static int create_pulse_train(uint16_t *pulses, protocol_t *protocol,
   return ESPiLight::ERROR_UNAVAILABLE_PROTOCOL;
 }
 
+static int create_pulse_train(uint16_t *pulses, protocol_t *protocol,
+                              const PilightParam_t *params, size_t count) {
+  if (count > MAX_PILIGHT_PARAMS) {
+    DebugLn("too many parameters");
+    return ESPiLight::ERROR_INVALID_PILIGHT_MSG;
+  }
+
+  JsonNode nodes[MAX_PILIGHT_PARAMS + 1];
+  return create_pulse_train(pulses, protocol,
+                            params_to_json(params, count, nodes));
+}
+
+static int create_pulse_train(uint16_t *pulses, protocol_t *protocol,
+                              const char *content) {
+  JsonNode *message = json_decode(content);
+  if (message == nullptr) {
+    Debug("invalid json: ");
+    DebugLn(content);
+    return ESPiLight::ERROR_INVALID_JSON;
+  }
+
+  int length = create_pulse_train(pulses, protocol, message);
+  json_delete(message);
+  return length;
+}
+
+static uint32_t pulse_train_airtime(const uint16_t *pulses, size_t length) {
+  uint32_t airtime = 0;
+  for (size_t i = 0; i < length; i++) {
+    airtime += pulses[i];
+  }
+  return airtime;
+}
+
+/*
+ * Strip whitespace outside of strings, so that equal commands with different
+ * formatting share a cache entry.
+ */
+static String canonical_command(const String &json) {
+  String command;
+  bool quoted = false;
+  bool escaped = false;
+
+  command.reserve(json.length());
+  for (unsigned int i = 0; i < json.length(); i++) {
+    const char c = json[i];
+    if (quoted) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        quoted = false;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (isspace(c)) {
+      continue;
+    }
+    command += c;
+  }
+  return command;
+}
+
+/*
+ * Pulse types are clustered like pilight does: a pulse matches a pulse type
+ * if both are within +-2 * 50 us. The ranges of the pulse types are
+ * precomputed, so no division is needed per comparison.
+ */
+typedef struct PulseTypes_t {
+  uint8_t count;
+  uint16_t lengths[MAX_PULSE_TYPES];
+  uint16_t min[MAX_PULSE_TYPES];
+  uint16_t max[MAX_PULSE_TYPES];
+} PulseTypes_t;
+
+/*
+ * Return the index of the pulse type matching pulse, a new pulse type is
+ * added if none matches. Returns -1 if there are too many pulse types.
+ */
+static int pulse_type(PulseTypes_t *types, uint16_t pulse) {
+  for (uint8_t i = 0; i < types->count; i++) {
+    if (pulse >= types->min[i] && pulse <= types->max[i]) {
+      return i;
+    }
+  }
+  if (types->count == MAX_PULSE_TYPES) {
+    return -1;
+  }
+  const uint32_t bucket = pulse / 50;
+  const uint32_t max = (bucket + 3) * 50 - 1;
+  types->lengths[types->count] = pulse;
+  types->min[types->count] = (uint16_t)(bucket > 2 ? (bucket - 2) * 50 : 0);
+  types->max[types->count] =
+      (uint16_t)std::min<uint32_t>(max, std::numeric_limits<uint16_t>::max());
+  return types->count++;
+}
+
+static uint16_t read_le16(const uint8_t *data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static bool encoded_pulse_train_valid(const uint8_t *data, size_t size) {
+  if (size < ENCODEDPULSETRAIN_HEADER_SIZE) {
+    return false;
+  }
+  const uint8_t nrtypes = data[0];
+  const uint8_t length = data[1];
+  if (nrtypes == 0 || nrtypes > MAX_PULSE_TYPES ||
+      size < (size_t)ENCODEDPULSETRAIN_SIZE(nrtypes, length)) {
+    return false;
+  }
+  const uint8_t *indices = data + ENCODEDPULSETRAIN_HEADER_SIZE + 2 * nrtypes;
+  for (unsigned int i = 0; i < length; i++) {
+    const uint8_t index = (indices[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+    if (index >= nrtypes) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void calc_lengths() {
   protocols_t *pnode = get_used_protocols();
   ESPiLight::minrawlen = std::numeric_limits<uint8_t>::max();
@@ -220,17 +416,34 @@ void ESPiLight::initReceiver(byte inputPin) {
 }
 
 uint8_t ESPiLight::receivePulseTrain(uint16_t *pulses) {
-  uint8_t length = nextPulseTrainLength();
+  uint8_t length = 0;
+  const uint16_t *source = borrowPulseTrain(&length);
 
-  if (length > 0) {
-    volatile PulseTrain_t &pulseTrain = _pulseTrains[_avaiablePulseTrain];
+  if (source != nullptr) {
+    memcpy(pulses, source, length * sizeof(uint16_t));
+    releasePulseTrain();
+  }
+  return length;
+}
+
+uint16_t *ESPiLight::borrowPulseTrain(uint8_t *length) {
+  *length = nextPulseTrainLength();
+
+  if (*length == 0) {
+    return nullptr;
+  }
+  // interruptHandler() never writes to a slot with non-zero length, so the
+  // pulses are stable and can be read without volatile until released.
+  return const_cast<uint16_t *>(_pulseTrains[_avaiablePulseTrain].pulses);
+}
+
+void ESPiLight::releasePulseTrain() {
+  volatile PulseTrain_t &pulseTrain = _pulseTrains[_avaiablePulseTrain];
+
+  if (pulseTrain.length > 0) {
     _avaiablePulseTrain = (_avaiablePulseTrain + 1) % RECEIVER_BUFFER_SIZE;
-    for (uint8_t i = 0; i < length; i++) {
-      pulses[i] = pulseTrain.pulses[i];
-    }
     pulseTrain.length = 0;
   }
-  return length;
 }
 
 uint8_t ESPiLight::nextPulseTrainLength() {
@@ -241,6 +454,10 @@ void ICACHE_RAM_ATTR ESPiLight::interruptHandler() {
   if (!_enabledReceiver) {
     return;
   }
+#if RECEIVER_STATS
+  const uint32_t start = ESP.getCycleCount();
+  volatile ReceiverStats_t &stats = _receiverStats;
+#endif
 
   volatile PulseTrain_t &pulseTrain = _pulseTrains[_actualPulseTrain];
   volatile uint16_t *codes = pulseTrain.pulses;
@@ -249,6 +466,18 @@ void ICACHE_RAM_ATTR ESPiLight::interruptHandler() {
     const unsigned long now = micros();
     const unsigned int duration = now - _lastChange;
     // Debug(duration); Debug(",");
+#if RECEIVER_STATS
+    const unsigned int bucket =
+        duration < 2 ? 0 : 31 - (unsigned int)__builtin_clz(duration);
+    stats.histogram[bucket < RECEIVER_STATS_BUCKETS
+                        ? bucket
+                        : RECEIVER_STATS_BUCKETS - 1]++;
+    if (duration <= minpulselen) {
+      stats.belowMinPulse++;
+    } else if (duration >= maxpulselen) {
+      stats.aboveMaxPulse++;
+    }
+#endif
     /* We first do some filtering (same as pilight BPF) */
     if (duration > minpulselen) {
       if (duration < maxpulselen) {
@@ -264,6 +493,7 @@ void ICACHE_RAM_ATTR ESPiLight::interruptHandler() {
             // Debug('l');
             pulseTrain.length = _nrpulses;
             _actualPulseTrain = (_actualPulseTrain + 1) % RECEIVER_BUFFER_SIZE;
+            _lastTrain = now;
           }
           _nrpulses = 0;
         }
@@ -272,7 +502,40 @@ void ICACHE_RAM_ATTR ESPiLight::interruptHandler() {
     }
   } else {
     Debug("_!_");
+#if RECEIVER_STATS
+    stats.overruns++;
+#endif
   }
+#if RECEIVER_STATS
+  stats.edges++;
+  const uint32_t cycles = ESP.getCycleCount() - start;
+  stats.isrCycles += cycles;
+  if (cycles > stats.isrMaxCycles) {
+    stats.isrMaxCycles = cycles;
+  }
+#endif
+}
+
+bool ESPiLight::receiverStats(ReceiverStats_t *stats) {
+#if RECEIVER_STATS
+  noInterrupts();
+  memcpy(stats, const_cast<ReceiverStats_t *>(&_receiverStats),
+         sizeof(*stats));
+  interrupts();
+  return true;
+#else
+  (void)stats;
+  return false;
+#endif
+}
+
+void ESPiLight::resetReceiverStats() {
+#if RECEIVER_STATS
+  noInterrupts();
+  memset(const_cast<ReceiverStats_t *>(&_receiverStats), 0,
+         sizeof(_receiverStats));
+  interrupts();
+#endif
 }
 
 void ESPiLight::resetReceiver() {
@@ -289,12 +552,10 @@ void ESPiLight::enableReceiver() { _enabledReceiver = true; }
 void ESPiLight::disableReceiver() { _enabledReceiver = false; }
 
 void ESPiLight::loop() {
-  int length = 0;
-  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  uint8_t length = 0;
+  uint16_t *pulses = borrowPulseTrain(&length);
 
-  length = receivePulseTrain(pulses);
-
-  if (length > 0) {
+  if (pulses != nullptr) {
     /*
     Debug("RAW (");
     Debug(length);
@@ -305,15 +566,43 @@ void ESPiLight::loop() {
     }
     DebugLn();
     */
-    parsePulseTrain(pulses, (uint8_t)length);
+    parsePulseTrain(pulses, length);
+    releasePulseTrain();
   }
+  transmitQueued();
 }
 
 ESPiLight::ESPiLight(int8_t outputPin) {
   _outputPin = outputPin;
   _callback = nullptr;
+  _messageCallback = nullptr;
+  _cstringCallback = nullptr;
   _rawCallback = nullptr;
   _echoEnabled = false;
+  _lastMatches = 0;
+  _cacheClock = 0;
+  _cacheSerial = 0;
+  for (PulseTrainCacheEntry_t &entry : _cache) {
+    entry.pulses = nullptr;
+    entry.length = 0;
+    entry.txrpt = 0;
+    entry.handle = 0;
+    entry.lastUse = 0;
+    entry.airtime = 0;
+  }
+  for (TransmitQueueEntry_t &entry : _queue) {
+    entry.handle = 0;
+    entry.repeats = 0;
+    entry.serial = 0;
+  }
+  _queueSerial = 0;
+  memset(&_transmitStats, 0, sizeof(_transmitStats));
+  _airtimeBudget = 0;
+  _airtimeWindow = 1000;
+  _airtimeWindowStart = 0;
+  _lbtQuiet = 0;
+  _lbtMaxDefer = 500;
+  _lbtPulses = 8;
 
   if (_outputPin >= 0) {
     pinMode((uint8_t)_outputPin, OUTPUT);
@@ -335,54 +624,211 @@ ESPiLight::ESPiLight(int8_t outputPin) {
   DebugLn(ESPiLight::maxpulselen);
 }
 
+ESPiLight::~ESPiLight() { invalidateCache(); }
+
 void ESPiLight::setCallback(ESPiLightCallBack callback) {
   _callback = callback;
 }
 
+void ESPiLight::setMessageCallback(PilightMessageCallBack callback) {
+  _messageCallback = callback;
+}
+
+void ESPiLight::setCStringCallback(ESPiLightCStringCallBack callback) {
+  _cstringCallback = callback;
+}
+
 void ESPiLight::setPulseTrainCallBack(PulseTrainCallBack rawCallback) {
   _rawCallback = rawCallback;
 }
 
+/*
+ * Transmit timing: the edges are written at absolute deadlines of the cycle
+ * counter instead of delaying after each digitalWrite(), so the write and
+ * loop overhead do not add up over a pulse train and its repeats. A write
+ * is started by its measured latency ahead of the deadline. The deviation
+ * of each pulse from its requested length is recorded.
+ */
+typedef struct EdgeTimer_t {
+  uint8_t pin;
+  uint32_t cyclesPerUs;
+  uint32_t latency;  // cycles of a digitalWrite()
+  uint32_t deadline;
+  uint32_t lastEdge;
+  uint32_t lastDeadline;
+  uint32_t edges;
+  uint32_t maxDeviation;  // cycles
+  uint64_t sumDeviation;
+} EdgeTimer_t;
+
+static void edge_timer_start(EdgeTimer_t *timer, uint8_t pin) {
+  timer->pin = pin;
+  timer->cyclesPerUs = clockCyclesPerMicrosecond();
+  const uint32_t start = ESP.getCycleCount();
+  digitalWrite(pin, LOW);
+  const uint32_t now = ESP.getCycleCount();
+  timer->latency = now - start;
+  timer->deadline = now + 2 * timer->latency;
+  timer->lastEdge = 0;
+  timer->lastDeadline = 0;
+  timer->edges = 0;
+  timer->maxDeviation = 0;
+  timer->sumDeviation = 0;
+}
+
+/*
+ * Write level at the deadline, which ends the previous pulse. The next
+ * deadline follows after duration us.
+ */
+static void edge_timer_write(EdgeTimer_t *timer, uint8_t level,
+                             uint32_t duration) {
+  const uint32_t start = timer->deadline - timer->latency;
+  while ((int32_t)(ESP.getCycleCount() - start) < 0) {
+  }
+  digitalWrite(timer->pin, level);
+  const uint32_t edge = ESP.getCycleCount() - timer->latency;
+
+  if (timer->edges > 0) {
+    const int32_t deviation =
+        (int32_t)((edge - timer->lastEdge) -
+                  (timer->deadline - timer->lastDeadline));
+    const uint32_t cycles = deviation < 0 ? -deviation : deviation;
+    if (cycles > timer->maxDeviation) {
+      timer->maxDeviation = cycles;
+    }
+    timer->sumDeviation += cycles;
+  }
+  timer->edges++;
+  timer->lastEdge = edge;
+  timer->lastDeadline = timer->deadline;
+  timer->deadline += duration * timer->cyclesPerUs;
+}
+
+void ESPiLight::countJitter(const EdgeTimer_t *timer) {
+  const uint32_t pulses = timer->edges > 1 ? timer->edges - 1 : 1;
+  _transmitStats.jitterMax =
+      (uint32_t)((uint64_t)timer->maxDeviation * 1000 / timer->cyclesPerUs);
+  _transmitStats.jitterMean =
+      (uint32_t)(timer->sumDeviation * 1000 / timer->cyclesPerUs / pulses);
+}
+
+bool ESPiLight::channelBusy() const {
+  if (!_enabledReceiver) {
+    return false;
+  }
+  // a pulse train was just received or is being received
+  const unsigned long now = micros();
+  return (now - _lastTrain < _lbtQuiet) ||
+         (now - _lastChange < _lbtQuiet && _nrpulses >= _lbtPulses);
+}
+
+void ESPiLight::listenBeforeTalk() {
+  if (_lbtQuiet == 0 || !channelBusy()) {
+    return;
+  }
+  const unsigned long start = millis();
+  _transmitStats.deferred++;
+  while (channelBusy()) {
+    if (millis() - start >= _lbtMaxDefer) {
+      _transmitStats.deferTimeouts++;
+      break;
+    }
+    delay(1);
+  }
+  _transmitStats.deferTime += millis() - start;
+}
+
+void ESPiLight::setListenBeforeTalk(uint32_t quiet, uint32_t maxDefer,
+                                    uint8_t pulses) {
+  _lbtQuiet = quiet;
+  _lbtMaxDefer = maxDefer;
+  _lbtPulses = pulses;
+}
+
+/*
+ * The transmit loop of all send functions. pulse(i) returns the length of
+ * pulse i in us, so a pulse train can be transmitted straight from its
+ * encoding.
+ */
+template <typename PulseSource>
+void ESPiLight::transmit(const PulseSource &pulse, size_t length,
+                         size_t repeats) {
+  if (_outputPin < 0) {
+    return;
+  }
+  listenBeforeTalk();
+  bool receiverState = _enabledReceiver;
+  _enabledReceiver = (_echoEnabled && receiverState);
+  EdgeTimer_t timer;
+  edge_timer_start(&timer, (uint8_t)_outputPin);
+  for (unsigned int r = 0; r < repeats; r++) {
+    for (unsigned int i = 0; i < length; i++) {
+      edge_timer_write(&timer, (i & 1) ? LOW : HIGH, pulse(i));
+    }
+  }
+  edge_timer_write(&timer, LOW, 0);
+  _enabledReceiver = receiverState;
+  countJitter(&timer);
+
+  uint32_t airtime = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    airtime += pulse(i);
+  }
+  countAirtime(airtime * repeats);
+}
+
 void ESPiLight::sendPulseTrain(const uint16_t *pulses, size_t length,
                                size_t repeats) {
-  if (_outputPin >= 0) {
-    bool receiverState = _enabledReceiver;
-    _enabledReceiver = (_echoEnabled && receiverState);
-    for (unsigned int r = 0; r < repeats; r++) {
-      for (unsigned int i = 0; i < length; i += 2) {
-        digitalWrite((uint8_t)_outputPin, HIGH);
-        delayMicroseconds(pulses[i]);
-        digitalWrite((uint8_t)_outputPin, LOW);
-        if (i + 1 < length) {
-          delayMicroseconds(pulses[i + 1]);
-        }
-      }
-    }
-    digitalWrite((uint8_t)_outputPin, LOW);
-    _enabledReceiver = receiverState;
+  transmit([pulses](size_t i) -> uint16_t { return pulses[i]; }, length,
+           repeats);
+}
+
+int ESPiLight::sendEncodedPulseTrain(const uint8_t *data, size_t size,
+                                     size_t repeats) {
+  if (!encoded_pulse_train_valid(data, size)) {
+    DebugLn("invalid encoded pulse train");
+    return ERROR_INVALID_PULSETRAIN_DATA;
   }
+  const uint8_t nrtypes = data[0];
+  const uint8_t length = data[1];
+  const uint8_t *indices = data + ENCODEDPULSETRAIN_HEADER_SIZE + 2 * nrtypes;
+  uint16_t plstypes[MAX_PULSE_TYPES];
+
+  for (uint8_t i = 0; i < nrtypes; i++) {
+    plstypes[i] = read_le16(data + ENCODEDPULSETRAIN_HEADER_SIZE + 2 * i);
+  }
+  if (repeats == 0) {
+    repeats = data[2] > 0 ? data[2] : 10;
+  }
+  // both pulses of a high/low pair share one byte
+  transmit(
+      [indices, &plstypes](size_t i) -> uint16_t {
+        const uint8_t pair = indices[i >> 1];
+        return plstypes[(i & 1) ? (pair >> 4) : (pair & 0x0F)];
+      },
+      length, repeats);
+  return length;
 }
 
 int ESPiLight::send(const String &protocol, const String &json,
                     size_t repeats) {
+  MEMORY_STATS_SCOPE(MEMORY_STATS_SEND);
   if (_outputPin < 0) {
     DebugLn("No output pin set, cannot send");
     return ERROR_NO_OUTPUT_PIN;
   }
-  int length = 0;
   uint16_t pulses[MAXPULSESTREAMLENGTH];
 
+  // not cached: createCode() may vary the pulse train, e.g. a rolling code
   protocol_t *protocol_listener = find_protocol(protocol.c_str());
-  length = create_pulse_train(pulses, protocol_listener, json);
+  int length = create_pulse_train(pulses, protocol_listener, json.c_str());
   if (length > 0) {
     /*
     DebugLn();
     Debug("send: ");
-    Debug(length);
-    Debug(" pulses (");
     Debug(protocol);
     Debug(", ");
-    Debug(content);
+    Debug(json);
     DebugLn(")");
     */
     if (repeats == 0) {
@@ -393,30 +839,303 @@ int ESPiLight::send(const String &protocol, const String &json,
   return length;
 }
 
+int ESPiLight::cachePulseTrain(const String &protocol, const String &json) {
+  const String command = canonical_command(json);
+  PulseTrainCacheEntry_t *victim = &_cache[0];
+
+  for (PulseTrainCacheEntry_t &entry : _cache) {
+    if (entry.handle > 0 && entry.protocol == protocol &&
+        entry.command == command) {
+      entry.lastUse = ++_cacheClock;
+      return entry.handle;
+    }
+    if (victim->handle > 0 &&
+        (entry.handle == 0 || entry.lastUse < victim->lastUse)) {
+      victim = &entry;
+    }
+  }
+
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+  protocol_t *protocol_listener = find_protocol(protocol.c_str());
+  int length = create_pulse_train(pulses, protocol_listener, json.c_str());
+  if (length <= 0) {
+    return length;
+  }
+
+  if (victim->length != length) {
+    delete[] victim->pulses;
+    victim->pulses = new uint16_t[length];
+  }
+  memcpy(victim->pulses, pulses, length * sizeof(uint16_t));
+  victim->airtime = pulse_train_airtime(pulses, length);
+  victim->protocol = protocol;
+  victim->command = command;
+  victim->length = (uint8_t)length;
+  victim->txrpt = protocol_listener->txrpt;
+  if (_cacheSerial == std::numeric_limits<int>::max()) {
+    _cacheSerial = 0;
+  }
+  victim->handle = ++_cacheSerial;
+  victim->lastUse = ++_cacheClock;
+  Debug("cached pulse train #");
+  DebugLn(victim->handle);
+  return victim->handle;
+}
+
+PulseTrainCacheEntry_t *ESPiLight::findCached(int handle) {
+  for (PulseTrainCacheEntry_t &entry : _cache) {
+    if (handle > 0 && entry.handle == handle) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+int ESPiLight::sendCached(int handle, size_t repeats) {
+  if (_outputPin < 0) {
+    DebugLn("No output pin set, cannot send");
+    return ERROR_NO_OUTPUT_PIN;
+  }
+  PulseTrainCacheEntry_t *entry = findCached(handle);
+  if (entry == nullptr) {
+    return ERROR_INVALID_HANDLE;
+  }
+  entry->lastUse = ++_cacheClock;
+  if (repeats == 0) {
+    repeats = entry->txrpt;
+  }
+  sendPulseTrain(entry->pulses, entry->length, repeats);
+  return entry->length;
+}
+
+/*
+ * The device addressed by a command, e.g. "id:1234,unit:1,", for the
+ * coalescing of queued commands.
+ */
+static String command_target(const String &json) {
+  static const char *const keys[] = {"id",   "systemcode", "programcode",
+                                     "unit", "unitcode",   "channel",
+                                     "all"};
+  String target;
+  JsonNode *message = json_decode(json.c_str());
+
+  for (const char *key : keys) {
+    JsonNode *member = json_find_member(message, key);
+    if (member != nullptr) {
+      char *value = json_encode(member);
+      target += key;
+      target += ':';
+      target += value;
+      target += ',';
+      json_free(value);
+    }
+  }
+  json_delete(message);
+  return target;
+}
+
+int ESPiLight::queue(const String &protocol, const String &json,
+                     size_t repeats) {
+  if (_outputPin < 0) {
+    DebugLn("No output pin set, cannot send");
+    return ERROR_NO_OUTPUT_PIN;
+  }
+  int handle = cachePulseTrain(protocol, json);
+  if (handle <= 0) {
+    return handle;
+  }
+
+  const String target = command_target(json);
+  TransmitQueueEntry_t *slot = nullptr;
+  for (TransmitQueueEntry_t &entry : _queue) {
+    if (entry.serial > 0 && entry.protocol == protocol &&
+        entry.target == target) {
+      slot = &entry;
+      _transmitStats.superseded++;
+      break;
+    }
+    if (entry.serial == 0 && slot == nullptr) {
+      slot = &entry;
+    }
+  }
+  if (slot == nullptr) {
+    return ERROR_QUEUE_FULL;
+  }
+  if (slot->serial == 0) {
+    slot->serial = ++_queueSerial;
+    slot->protocol = protocol;
+    slot->target = target;
+    _transmitStats.depth++;
+  }
+  slot->command = json;
+  slot->handle = handle;
+  slot->repeats = repeats;
+  _transmitStats.queued++;
+  return _transmitStats.depth;
+}
+
+void ESPiLight::setAirtimeBudget(uint32_t airtime, uint32_t window) {
+  _airtimeBudget = airtime;
+  _airtimeWindow = window;
+}
+
+void ESPiLight::transmitStats(TransmitStats_t *stats) {
+  airtimeAvailable(0);  // start a new window if due
+  *stats = _transmitStats;
+}
+
+void ESPiLight::resetTransmitStats() {
+  _transmitStats.queued = 0;
+  _transmitStats.superseded = 0;
+  _transmitStats.sent = 0;
+  _transmitStats.totalAirtime = 0;
+  _transmitStats.deferred = 0;
+  _transmitStats.deferTimeouts = 0;
+  _transmitStats.deferTime = 0;
+}
+
+bool ESPiLight::airtimeAvailable(uint32_t airtime) {
+  if (millis() - _airtimeWindowStart >= _airtimeWindow) {
+    _airtimeWindowStart = millis();
+    _transmitStats.airtime = 0;
+  }
+  return _airtimeBudget == 0 || _transmitStats.airtime == 0 ||
+         _transmitStats.airtime + airtime <= _airtimeBudget;
+}
+
+void ESPiLight::countAirtime(uint32_t airtime) {
+  airtimeAvailable(0);
+  _transmitStats.airtime += airtime;
+  _transmitStats.totalAirtime += airtime;
+}
+
+void ESPiLight::transmitQueued() {
+  TransmitQueueEntry_t *next = nullptr;
+
+  for (TransmitQueueEntry_t &entry : _queue) {
+    if (entry.serial > 0 && (next == nullptr || entry.serial < next->serial)) {
+      next = &entry;
+    }
+  }
+  if (next == nullptr) {
+    return;
+  }
+
+  PulseTrainCacheEntry_t *cached = findCached(next->handle);
+  if (cached == nullptr) {
+    // evicted from the cache meanwhile
+    cached = findCached(cachePulseTrain(next->protocol, next->command));
+  }
+  if (cached != nullptr) {
+    const size_t repeats = next->repeats > 0 ? next->repeats : cached->txrpt;
+    if (!airtimeAvailable(cached->airtime * repeats)) {
+      return;
+    }
+    sendCached(cached->handle, repeats);
+    _transmitStats.sent++;
+  }
+  next->serial = 0;
+  next->protocol = String();
+  next->command = String();
+  next->target = String();
+  _transmitStats.depth--;
+}
+
+void ESPiLight::invalidateCache(const String &protocol) {
+  for (PulseTrainCacheEntry_t &entry : _cache) {
+    if (protocol.length() == 0 || entry.protocol == protocol) {
+      delete[] entry.pulses;
+      entry.pulses = nullptr;
+      entry.length = 0;
+      entry.handle = 0;
+      entry.protocol = String();
+      entry.command = String();
+    }
+  }
+}
+
+int ESPiLight::send(const char *protocol, const PilightParam_t *params,
+                    size_t count, size_t repeats) {
+  MEMORY_STATS_SCOPE(MEMORY_STATS_SEND);
+  if (_outputPin < 0) {
+    DebugLn("No output pin set, cannot send");
+    return ERROR_NO_OUTPUT_PIN;
+  }
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+
+  protocol_t *protocol_listener = find_protocol(protocol);
+  int length = create_pulse_train(pulses, protocol_listener, params, count);
+  if (length > 0) {
+    if (repeats == 0) {
+      repeats = protocol_listener->txrpt;
+    }
+    sendPulseTrain(pulses, (unsigned)length, repeats);
+  }
+  return length;
+}
+
 int ESPiLight::createPulseTrain(uint16_t *pulses, const String &protocol_id,
                                 const String &content) {
   protocol_t *protocol = find_protocol(protocol_id.c_str());
+  return create_pulse_train(pulses, protocol, content.c_str());
+}
+
+int ESPiLight::createPulseTrain(uint16_t *pulses, const char *protocol_id,
+                                const char *content) {
+  protocol_t *protocol = find_protocol(protocol_id);
   return create_pulse_train(pulses, protocol, content);
 }
 
+int ESPiLight::createPulseTrain(uint16_t *pulses, const char *protocol_id,
+                                const PilightParam_t *params, size_t count) {
+  protocol_t *protocol = find_protocol(protocol_id);
+  return create_pulse_train(pulses, protocol, params, count);
+}
+
+#if PROTOCOL_STATS
+static void count_cycles(uint32_t cycles, uint64_t *total, uint32_t *max) {
+  *total += cycles;
+  if (cycles > *max) {
+    *max = cycles;
+  }
+}
+#endif
+
 size_t ESPiLight::parsePulseTrain(uint16_t *pulses, uint8_t length) {
+  MEMORY_STATS_SCOPE(MEMORY_STATS_PARSE);
   size_t matches = 0;
   protocol_t *protocol = nullptr;
   protocols_t *pnode = get_used_protocols();
 
   // DebugLn("piLightParsePulseTrain start");
-  while ((pnode != nullptr) && (_callback != nullptr)) {
+  while ((pnode != nullptr) &&
+         (_callback != nullptr || _messageCallback != nullptr ||
+          _cstringCallback != nullptr)) {
     protocol = pnode->listener;
 
     if (protocol->parseCode != nullptr && protocol->validate != nullptr) {
       protocol->raw = pulses;
       protocol->rawlen = length;
 
-      if (protocol->validate() == 0) {
+#if PROTOCOL_STATS
+      protocol_stats_t &stats = protocol->stats;
+      uint32_t start = ESP.getCycleCount();
+#endif
+      const int valid = protocol->validate();
+#if PROTOCOL_STATS
+      count_cycles(ESP.getCycleCount() - start, &stats.validate_cycles,
+                   &stats.validate_max_cycles);
+      stats.validate_calls++;
+#endif
+
+      if (valid == 0) {
+#if PROTOCOL_STATS
+        stats.validate_accepts++;
+#endif
         Debug("pulses: ");
         Debug(length);
         Debug(" possible protocol: ");
-        DebugLn(protocol->id);
+        DebugLn(FPSTR(protocol->id));
 
         if (protocol->first > 0) {
           protocol->first = protocol->second;
@@ -432,20 +1151,29 @@ size_t ESPiLight::parsePulseTrain(uint16_t *pulses, uint8_t length) {
         }
 
         protocol->message = nullptr;
+#if PROTOCOL_STATS
+        start = ESP.getCycleCount();
+#endif
         protocol->parseCode();
+#if PROTOCOL_STATS
+        count_cycles(ESP.getCycleCount() - start, &stats.parse_cycles,
+                     &stats.parse_max_cycles);
+#endif
         if (protocol->message != nullptr) {
+#if PROTOCOL_STATS
+          stats.messages++;
+#endif
           matches++;
           protocol->repeats++;
 
-          fire_callback(protocol, _callback);
-
-          json_delete(protocol->message);
-          protocol->message = nullptr;
+          fire_callback(protocol, _callback, _messageCallback,
+                        _cstringCallback);
         }
       }
     }
     pnode = pnode->next;
   }
+  _lastMatches = matches;
   if (_rawCallback != nullptr) {
     (_rawCallback)(pulses, length);
   }
@@ -455,131 +1183,269 @@ size_t ESPiLight::parsePulseTrain(uint16_t *pulses, uint8_t length) {
   return matches;
 }
 
-static void fire_callback(protocol_t *protocol, ESPiLightCallBack callback) {
+size_t ESPiLight::lastMatches() const { return _lastMatches; }
+
+PilightMessage::PilightMessage(const char *protocolId,
+                               const JsonNode *message,
+                               PilightRepeatStatus_t status, size_t repeats)
+    : _protocolId(protocolId),
+      _message(message),
+      _status(status),
+      _repeats(repeats),
+      _json(nullptr),
+      _deviceId(nullptr) {
+  _protocol[0] = '\0';
+}
+
+PilightMessage::~PilightMessage() { json_free(_json); }
+
+bool PilightMessage::isProtocol(const char *protocol) const {
+  return strcmp_P(protocol, _protocolId) == 0;
+}
+
+const char *PilightMessage::protocol() {
+  if (_protocol[0] == '\0') {
+    strncpy_P(_protocol, _protocolId, sizeof(_protocol) - 1);
+    _protocol[sizeof(_protocol) - 1] = '\0';
+  }
+  return _protocol;
+}
+
+const char *PilightMessage::json() {
+  if (_json == nullptr) {
+    _json = json_encode(const_cast<JsonNode *>(_message));
+  }
+  return _json;
+}
+
+const char *PilightMessage::deviceId() {
+  if (_deviceId == nullptr) {
+    double itmp;
+
+    if (number("id", &itmp)) {
+      snprintf(_number, sizeof(_number), "%d", (int)round(itmp));
+      _deviceId = _number;
+    } else {
+      _deviceId = string("id");
+      if (_deviceId == nullptr) {
+        _deviceId = "";
+      }
+    }
+  }
+  return _deviceId;
+}
+
+size_t PilightMessage::msgpack(uint8_t *buffer, size_t size) const {
+  return json_msgpack(_message, buffer, size);
+}
+
+bool PilightMessage::number(const char *key, double *value) const {
+  return json_find_number(const_cast<JsonNode *>(_message), key, value) == 0;
+}
+
+const char *PilightMessage::string(const char *key) const {
+  char *value;
+
+  if (json_find_string(const_cast<JsonNode *>(_message), key, &value) != 0) {
+    return nullptr;
+  }
+  return value;
+}
+
+/*
+ * Determine the repeat status of protocol->message. The message becomes
+ * protocol->old_message, unless a validated message is known already.
+ * Messages are compared as trees, they are not encoded for the status.
+ */
+static PilightRepeatStatus_t update_repeat_status(protocol_t *protocol) {
   PilightRepeatStatus_t status = FIRST;
-  char *content = json_encode(protocol->message);
-  String deviceId = "";
-  double itmp;
-  char *stmp;
 
-  if ((protocol->repeats <= 1) || (protocol->old_content == nullptr)) {
+  if ((protocol->repeats <= 1) || (protocol->old_message == nullptr)) {
     status = FIRST;
-    json_free(protocol->old_content);
-    protocol->old_content = content;
   } else if (!(protocol->repeats & 0x80)) {
-    if (strcmp(content, protocol->old_content) == 0) {
+    if (json_equal(protocol->message, protocol->old_message)) {
       protocol->repeats |= 0x80;
       status = VALID;
     } else {
       status = INVALID;
     }
-    json_free(protocol->old_content);
-    protocol->old_content = content;
   } else {
-    status = KNOWN;
-    json_free(content);
+    return KNOWN;
   }
-  if (json_find_number(protocol->message, "id", &itmp) == 0) {
-    deviceId = String((int)round(itmp));
-  } else if (json_find_string(protocol->message, "id", &stmp) == 0) {
-    deviceId = String(stmp);
-  };
-  (callback)(String(protocol->id), String(protocol->old_content), status,
-             protocol->repeats & 0x7F, deviceId);
+  json_delete(protocol->old_message);
+  protocol->old_message = protocol->message;
+  return status;
+}
+
+static void fire_callback(protocol_t *protocol, ESPiLightCallBack callback,
+                          PilightMessageCallBack messageCallback,
+                          ESPiLightCStringCallBack cstringCallback) {
+  PilightRepeatStatus_t status = update_repeat_status(protocol);
+  {
+    // the reported message is the validated one for KNOWN repeats
+    PilightMessage message(protocol->id, protocol->old_message, status,
+                           protocol->repeats & 0x7F);
+
+    if (messageCallback != nullptr) {
+      (messageCallback)(message);
+    }
+    if (cstringCallback != nullptr) {
+      const char *json = message.json();
+      (cstringCallback)(message.protocol(), json ? json : "", status,
+                        message.repeats(), message.deviceId());
+    }
+    if (callback != nullptr) {
+      const char *json = message.json();
+      (callback)(String(FPSTR(protocol->id)), String(json ? json : ""),
+                 status, message.repeats(), String(message.deviceId()));
+    }
+  }
+  if (protocol->message != protocol->old_message) {
+    json_delete(protocol->message);
+  }
+  protocol->message = nullptr;
 }
 
 String ESPiLight::pulseTrainToString(const uint16_t *codes, size_t length) {
-  bool match = false;
-  int diff = 0;
+  char data[MAXPULSETRAINSTRINGSIZE];
 
-  uint8_t nrpulses = 0;  // number of pulse types
-  uint16_t plstypes[MAX_PULSE_TYPES] = {};
+  if (length > MAXPULSESTREAMLENGTH ||
+      pulseTrainToString(codes, length, data, sizeof(data)) < 0) {
+    return String("");
+  }
+  return String(data);
+}
 
-  String data("");
-  data.reserve(6 + length);
-  data += "c:";
+int ESPiLight::pulseTrainToString(const uint16_t *codes, size_t length,
+                                  char *buffer, size_t size) {
+  PulseTypes_t types;
+  size_t pos = 0;
+  types.count = 0;
+
+  // writes c at pos if it fits (leaving room for the null) and counts it
+  auto put = [&](char c) {
+    if (pos + 1 < size) {
+      buffer[pos] = c;
+    }
+    pos++;
+  };
+
+  put('c');
+  put(':');
   for (unsigned int i = 0; i < length; i++) {
-    match = false;
-    for (uint8_t j = 0; j < MAX_PULSE_TYPES; j++) {
-      // We device these numbers by 10 to normalize them a bit
-      diff = (plstypes[j] / 50) - (codes[i] / 50);
-      if ((diff >= -2) && (diff <= 2)) {
-        // Write numbers
-        data += (char)('0' + ((char)j));
-        match = true;
-        break;
+    int j = pulse_type(&types, codes[i]);
+    if (j < 0) {
+      DebugLn("too many pulse types");
+      if (size > 0) {
+        buffer[0] = '\0';
       }
+      return ERROR_PULSETRAIN_PULSE_TYPES;
     }
-    if (!match) {
-      plstypes[nrpulses++] = codes[i];
-      data += (char)('0' + ((char)(nrpulses - 1)));
-      if (nrpulses >= MAX_PULSE_TYPES) {
-        DebugLn("too many pulse types");
-        return String("");
-      }
+    put((char)('0' + j));
+  }
+  put(';');
+  put('p');
+  put(':');
+  for (uint8_t i = 0; i < types.count; i++) {
+    char digits[5];
+    uint8_t n = 0;
+    uint16_t value = types.lengths[i];
+    do {
+      digits[n++] = (char)('0' + value % 10);
+      value /= 10;
+    } while (value > 0);
+    while (n > 0) {
+      put(digits[--n]);
+    }
+    if (i + 1 < types.count) {
+      put(',');
     }
   }
-  data += ";p:";
-  for (uint8_t i = 0; i < nrpulses; i++) {
-    data += plstypes[i];
-    if (i + 1 < nrpulses) {
-      data += ',';
+  put('@');
+  if (size > 0) {
+    buffer[std::min(pos, size - 1)] = '\0';
+  }
+  return (int)pos;
+}
+
+int ESPiLight::encodePulseTrain(const uint16_t *pulses, size_t length,
+                                uint8_t *data, size_t maxsize,
+                                uint8_t repeats) {
+  PulseTypes_t types;
+  types.count = 0;
+
+  if (length > MAXPULSESTREAMLENGTH ||
+      maxsize < ENCODEDPULSETRAIN_SIZE(0, length)) {
+    return ERROR_PULSETRAIN_BUFFER_SIZE;
+  }
+  uint8_t *indices = data + ENCODEDPULSETRAIN_HEADER_SIZE;
+  // indices are first written behind the header and moved behind the pulse
+  // type table when the number of pulse types is known.
+  memset(indices, 0, (length + 1) / 2);
+  for (unsigned int i = 0; i < length; i++) {
+    int j = pulse_type(&types, pulses[i]);
+    if (j < 0) {
+      DebugLn("too many pulse types");
+      return ERROR_PULSETRAIN_PULSE_TYPES;
     }
+    indices[i >> 1] |= (uint8_t)(j << ((i & 1) << 2));
+  }
+
+  const uint8_t nrtypes = types.count;
+  const size_t size = ENCODEDPULSETRAIN_SIZE(nrtypes, length);
+  if (maxsize < size) {
+    return ERROR_PULSETRAIN_BUFFER_SIZE;
   }
-  data += '@';
-  return data;
+  memmove(indices + 2 * nrtypes, indices, (length + 1) / 2);
+  data[0] = nrtypes;
+  data[1] = (uint8_t)length;
+  data[2] = repeats;
+  for (uint8_t j = 0; j < nrtypes; j++) {
+    data[ENCODEDPULSETRAIN_HEADER_SIZE + 2 * j] = (uint8_t)types.lengths[j];
+    data[ENCODEDPULSETRAIN_HEADER_SIZE + 2 * j + 1] =
+        (uint8_t)(types.lengths[j] >> 8);
+  }
+  return (int)size;
 }
 
-int ESPiLight::stringToPulseTrain(const String &data, uint16_t *codes,
-                                  size_t maxlength) {
-  unsigned int length = 0;    // length of pulse train
-  unsigned int nrpulses = 0;  // number of pulse types
-  uint16_t plstypes[MAX_PULSE_TYPES] = {};
-
-  // validate data string
-  int scode = data.indexOf('c') + 2;
-  if (scode < 2 || (unsigned)scode > data.length()) {
-    DebugLn("'c' not found in data string, or has no data");
-    return ERROR_INVALID_PULSETRAIN_MSG_C;
-  }
-  int spulse = data.indexOf('p') + 2;
-  if (spulse < 2 || (unsigned)spulse > data.length()) {
-    DebugLn("'p' not found in data string, or has no data");
-    return ERROR_INVALID_PULSETRAIN_MSG_P;
-  }
-  // parsing pulse types
-  unsigned int start = (unsigned)spulse;
-  int end = data.indexOf(',', start);
-  while (end > 0) {
-    plstypes[nrpulses++] =
-        (uint16_t)data.substring(start, (unsigned)end).toInt();
-    start = (unsigned)end + 1;
-    end = data.indexOf(',', start);
-  }
-  end = data.indexOf(';', start);
-  if (end < 0) {
-    end = data.indexOf('@', start);
+int ESPiLight::decodePulseTrain(const uint8_t *data, size_t size,
+                                uint16_t *pulses, size_t maxlength) {
+  if (!encoded_pulse_train_valid(data, size)) {
+    DebugLn("invalid encoded pulse train");
+    return ERROR_INVALID_PULSETRAIN_DATA;
   }
-  if (end < 0) {
-    DebugLn("';' or '@' not found in data string");
-    return ERROR_INVALID_PULSETRAIN_MSG_END;
+  const uint8_t nrtypes = data[0];
+  const uint8_t length = data[1];
+  const uint8_t *indices = data + ENCODEDPULSETRAIN_HEADER_SIZE + 2 * nrtypes;
+
+  if (length > maxlength) {
+    return ERROR_PULSETRAIN_BUFFER_SIZE;
   }
-  plstypes[nrpulses++] = (uint16_t)data.substring(start, (unsigned)end).toInt();
-  // parsing pulses
-  int pulse_index = 0;
-  for (unsigned int i = (unsigned)scode; i < data.length(); i++) {
-    if ((data[i] == ';') || (data[i] == '@')) break;
-    if (i >= maxlength) break;
-    pulse_index = data[i] - '0';
-    if ((pulse_index < 0) || ((unsigned)pulse_index >= nrpulses)) {
-      DebugLn("Pulse type not defined");
-      return ERROR_INVALID_PULSETRAIN_MSG_TYPE;
-    }
-    codes[length++] = plstypes[pulse_index];
+  for (unsigned int i = 0; i < length; i++) {
+    const uint8_t index = (indices[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+    pulses[i] = read_le16(data + ENCODEDPULSETRAIN_HEADER_SIZE + 2 * index);
   }
   return length;
 }
 
+int ESPiLight::stringToPulseTrain(const String &data, uint16_t *codes,
+                                  size_t maxlength) {
+  PulseTrainStringParser parser(codes, maxlength);
+
+  for (const char *c = data.c_str(); *c != '\0'; c++) {
+    if (parser.parse(*c)) {
+      return (int)parser.length();
+    }
+    if (parser.error() != 0) {
+      return parser.error();
+    }
+  }
+  if (parser.finish()) {
+    return (int)parser.length();
+  }
+  return parser.error();
+}
+
 int ESPiLight::stringToRepeats(const String &data) {
   // parsing (optional) repeats
   int srepeat = data.indexOf('r') + 2;
@@ -596,10 +1462,210 @@ int ESPiLight::stringToRepeats(const String &data) {
     DebugLn("';' or '@' not found in data string");
     return ERROR_INVALID_PULSETRAIN_MSG_END;
   }
-  return data.substring(start, (unsigned)end).toInt();
+  int repeats = 0;
+  for (unsigned int i = start; i < (unsigned)end && isdigit(data[i]); i++) {
+    repeats = repeats * 10 + (data[i] - '0');
+  }
+  return repeats;
+}
+
+PulseTrainStringParser::PulseTrainStringParser(uint16_t *pulses,
+                                               size_t maxlength)
+    : _pulses(pulses), _maxlength(maxlength) {
+  reset();
+  _length = 0;
+  _repeats = -1;
+}
+
+void PulseTrainStringParser::reset() {
+  _nrtypes = 0;
+  _maxindex = 0;
+  _number = 0;
+  _digits = false;
+  _codes = false;
+  _started = false;
+  _complete = false;
+  _error = 0;
+  _state = KEY;
+}
+
+bool PulseTrainStringParser::parse(Stream &stream) {
+  while (stream.available() > 0) {
+    if (parse((char)stream.read())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PulseTrainStringParser::parse(char c) {
+  if (_complete) {
+    reset();
+  }
+  if (c == '@') {
+    return endMessage();
+  }
+  if (_state == INVALID) {
+    return false;
+  }
+  if (c == ';') {
+    endSection();
+    return false;
+  }
+
+  switch (_state) {
+    case KEY:
+      if (isspace(c)) {
+        break;
+      }
+      if (!_started) {
+        // a new message starts, forget about the previous one
+        _started = true;
+        _length = 0;
+        _repeats = -1;
+        _error = 0;
+      }
+      _key = c;
+      _state = COLON;
+      break;
+    case COLON:
+      if (c != ':') {
+        DebugLn("':' not found after section key");
+        fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_END);
+      } else if (_key == 'c') {
+        _codes = true;
+        _length = 0;
+        _maxindex = 0;
+        _state = CODES;
+      } else if (_key == 'p') {
+        _nrtypes = 0;
+        _state = TYPES;
+      } else if (_key == 'r') {
+        _state = REPEATS;
+      } else {
+        _state = SKIP;
+      }
+      break;
+    case CODES: {
+      const uint8_t index = (uint8_t)(c - '0');
+      if (index >= MAX_PULSE_TYPES) {
+        DebugLn("Pulse type not defined");
+        fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_TYPE);
+      } else if (_length >= _maxlength) {
+        DebugLn("Pulse train too long");
+        fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_LENGTH);
+      } else {
+        // store the pulse type, resolved when the message is complete
+        _pulses[_length++] = index;
+        if (index > _maxindex) {
+          _maxindex = index;
+        }
+      }
+      break;
+    }
+    case TYPES:
+      if (c == ',') {
+        pushNumber();
+        break;
+      }
+      // fall through
+    case REPEATS:
+      if (!isdigit(c) || _number > 6553) {
+        DebugLn("invalid number in data string");
+        fail(_state == TYPES ? ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_P
+                             : ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_R);
+        break;
+      }
+      _number = _number * 10 + (uint32_t)(c - '0');
+      _digits = true;
+      break;
+    case SKIP:
+    case INVALID:
+      break;
+  }
+  return false;
+}
+
+bool PulseTrainStringParser::finish() {
+  if (!_started || _complete) {
+    return false;
+  }
+  return parse('@');
+}
+
+void PulseTrainStringParser::fail(int error) {
+  _error = error;
+  _state = INVALID;
+}
+
+bool PulseTrainStringParser::pushNumber() {
+  if (!_digits || _number > std::numeric_limits<uint16_t>::max() ||
+      _nrtypes >= MAX_PULSE_TYPES) {
+    DebugLn("invalid pulse type in data string");
+    fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_P);
+    return false;
+  }
+  _plstypes[_nrtypes++] = (uint16_t)_number;
+  _number = 0;
+  _digits = false;
+  return true;
+}
+
+bool PulseTrainStringParser::endSection() {
+  bool success = true;
+
+  if (_state == TYPES) {
+    success = pushNumber();
+  } else if (_state == REPEATS) {
+    if (_digits) {
+      _repeats = (int)_number;
+    } else {
+      DebugLn("'r' has no data");
+      fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_R);
+      success = false;
+    }
+  } else if (_state == COLON) {
+    DebugLn("':' not found after section key");
+    fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_END);
+    success = false;
+  }
+  if (success) {
+    _number = 0;
+    _digits = false;
+    _state = KEY;
+  }
+  return success;
+}
+
+bool PulseTrainStringParser::endMessage() {
+  if (_state != INVALID && endSection()) {
+    if (!_codes || _length == 0) {
+      DebugLn("'c' not found in data string, or has no data");
+      fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_C);
+    } else if (_nrtypes == 0) {
+      DebugLn("'p' not found in data string, or has no data");
+      fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_P);
+    } else if (_maxindex >= _nrtypes) {
+      DebugLn("Pulse type not defined");
+      fail(ESPiLight::ERROR_INVALID_PULSETRAIN_MSG_TYPE);
+    }
+  }
+  if (_state == INVALID) {
+    const int error = _error;
+    reset();
+    _error = error;
+    _length = 0;
+    return false;
+  }
+  for (size_t i = 0; i < _length; i++) {
+    _pulses[i] = _plstypes[_pulses[i]];
+  }
+  _complete = true;
+  return true;
 }
 
 void ESPiLight::limitProtocols(const String &protos) {
+  MEMORY_STATS_SCOPE(MEMORY_STATS_LIMIT_PROTOCOLS);
   if (!json_validate(protos.c_str())) {
     DebugLn("Protocol limit argument is not a valid json message!");
     return;
@@ -646,7 +1712,7 @@ void ESPiLight::limitProtocols(const String &protos) {
     used_protocols = new_node;
 
     Debug("activated protocol ");
-    DebugLn(templ->listener->id);
+    DebugLn(FPSTR(templ->listener->id));
     proto_count++;
 
     if (curr == message->children.tail) {
@@ -663,7 +1729,7 @@ static String protocols_to_array(protocols_t *pnode) {
   protocols_t *tmp = pnode;
   size_t needed_len = 2;  // []
   while (tmp != nullptr) {
-    needed_len += strlen(tmp->listener->id) + 3;  // "xx",
+    needed_len += strlen_P(tmp->listener->id) + 3;  // "xx",
     tmp = tmp->next;
   }
 
@@ -680,7 +1746,7 @@ static String protocols_to_array(protocols_t *pnode) {
       ret += ",";
     }
     ret += '"';
-    ret += pnode->listener->id;
+    ret += FPSTR(pnode->listener->id);
     ret += '"';
     pnode = pnode->next;
   }
@@ -697,6 +1763,122 @@ String ESPiLight::enabledProtocols() {
   return protocols_to_array(get_used_protocols());
 }
 
+bool ESPiLight::protocolStats(const String &protocol,
+                              PilightProtocolStats_t *stats) {
+#if PROTOCOL_STATS
+  protocols_t *pnode = find_protocol_node(protocol.c_str());
+  if (pnode == nullptr) {
+    return false;
+  }
+  const protocol_stats_t &pstats = pnode->listener->stats;
+  stats->validateCalls = pstats.validate_calls;
+  stats->validateAccepts = pstats.validate_accepts;
+  stats->messages = pstats.messages;
+  stats->validateCycles = pstats.validate_cycles;
+  stats->validateMaxCycles = pstats.validate_max_cycles;
+  stats->parseCycles = pstats.parse_cycles;
+  stats->parseMaxCycles = pstats.parse_max_cycles;
+  return true;
+#else
+  (void)protocol;
+  (void)stats;
+  return false;
+#endif
+}
+
+#if PROTOCOL_STATS
+static void append_number(String &str, const char *key, uint64_t value) {
+  // Arduino String has no 64 bit conversion on all platforms
+  char buffer[21];
+  char *digits = &buffer[sizeof(buffer) - 1];
+  *digits = '\0';
+  do {
+    *--digits = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  str += '"';
+  str += key;
+  str += "\":";
+  str += digits;
+}
+#endif
+
+String ESPiLight::protocolStats() {
+  String ret = "{";
+
+#if PROTOCOL_STATS
+  for (protocols_t *pnode = get_used_protocols(); pnode != nullptr;
+       pnode = pnode->next) {
+    const protocol_stats_t &stats = pnode->listener->stats;
+    if (ret.length() > 1) {
+      ret += ',';
+    }
+    ret += '"';
+    ret += FPSTR(pnode->listener->id);
+    ret += "\":{";
+    append_number(ret, "validate_calls", stats.validate_calls);
+    ret += ',';
+    append_number(ret, "validate_accepts", stats.validate_accepts);
+    ret += ',';
+    append_number(ret, "messages", stats.messages);
+    ret += ',';
+    append_number(ret, "validate_cycles", stats.validate_cycles);
+    ret += ',';
+    append_number(ret, "validate_max_cycles", stats.validate_max_cycles);
+    ret += ',';
+    append_number(ret, "parse_cycles", stats.parse_cycles);
+    ret += ',';
+    append_number(ret, "parse_max_cycles", stats.parse_max_cycles);
+    ret += '}';
+  }
+#endif
+  ret += '}';
+
+  return ret;
+}
+
+void ESPiLight::resetProtocolStats() {
+#if PROTOCOL_STATS
+  for (protocols_t *pnode = get_protocols(); pnode != nullptr;
+       pnode = pnode->next) {
+    memset(&pnode->listener->stats, 0, sizeof(pnode->listener->stats));
+  }
+#endif
+}
+
+bool ESPiLight::memoryStats(MemoryStats_t *stats,
+                           MemoryStatsOperation_t operation) {
+#if MEMORY_STATS
+  if (operation == MEMORY_STATS_TOTAL) {
+    stats->calls = 0;
+    stats->allocations = memtrack_stats.allocations;
+    stats->frees = memtrack_stats.frees;
+    stats->bytes = memtrack_stats.bytes;
+    stats->peak = memtrack_stats.peak;
+    stats->retained = (int32_t)memtrack_stats.current;
+  } else if (operation < MEMORY_STATS_OPERATIONS) {
+    *stats = memory_stats[operation];
+  } else {
+    return false;
+  }
+  return true;
+#else
+  (void)stats;
+  (void)operation;
+  return false;
+#endif
+}
+
+void ESPiLight::resetMemoryStats() {
+#if MEMORY_STATS
+  memset(memory_stats, 0, sizeof(memory_stats));
+  memtrack_stats.allocations = 0;
+  memtrack_stats.frees = 0;
+  memtrack_stats.bytes = 0;
+  memtrack_stats.peak = memtrack_stats.current;
+#endif
+}
+
 void ESPiLight::setEchoEnabled(bool enabled) { _echoEnabled = enabled; }
 
 void ESPiLight::setErrorOutput(Print &output) { set_aprintf_output(&output); }
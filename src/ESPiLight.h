@@ -30,8 +30,46 @@
 #define MAXPULSESTREAMLENGTH 255
 #endif
 
+#ifndef PULSETRAIN_CACHE_SIZE
+#define PULSETRAIN_CACHE_SIZE 8
+#endif
+
+#ifndef TRANSMIT_QUEUE_SIZE
+#define TRANSMIT_QUEUE_SIZE 8
+#endif
+
+#ifndef MAX_PILIGHT_PARAMS
+#define MAX_PILIGHT_PARAMS 12
+#endif
+
+/**
+ * Set RECEIVER_STATS to 1 to let interruptHandler() collect receiver
+ * statistics, see receiverStats().
+ */
+#ifndef RECEIVER_STATS
+#define RECEIVER_STATS 0
+#endif
+
 #define MAX_PULSE_TYPES 16
 
+/**
+ * Buffer size (including terminating null) sufficient for every pulse train
+ * formatted by pulseTrainToString(): "c:", pulses, ";p:", pulse types of up
+ * to five digits separated by ',' and "@".
+ */
+#define MAXPULSETRAINSTRINGSIZE (7 + MAXPULSESTREAMLENGTH + 6 * MAX_PULSE_TYPES)
+
+/**
+ * Size of the binary pulse train encoding: header (number of pulse types,
+ * number of pulses, repeats), pulse type table (uint16_t little endian)
+ * and the pulse type indices packed into nibbles.
+ */
+#define ENCODEDPULSETRAIN_HEADER_SIZE 3
+#define ENCODEDPULSETRAIN_SIZE(types, length) \
+  (ENCODEDPULSETRAIN_HEADER_SIZE + 2 * (types) + ((length) + 1) / 2)
+#define MAXENCODEDPULSETRAINSIZE \
+  ENCODEDPULSETRAIN_SIZE(MAX_PULSE_TYPES, MAXPULSESTREAMLENGTH)
+
 enum PilightRepeatStatus_t { FIRST, INVALID, VALID, KNOWN };
 
 typedef struct PulseTrain_t {
@@ -39,9 +77,195 @@ typedef struct PulseTrain_t {
   uint8_t length;
 } PulseTrain_t;
 
+/**
+ * Parameter of a Pilight command, e.g. {"unit", nullptr, 1} or
+ * {"state", "on", 0}. string is nullptr for numeric parameters.
+ */
+typedef struct PilightParam_t {
+  const char *key;
+  const char *string;
+  double number;
+} PilightParam_t;
+
+/**
+ * Decode statistics of a protocol, counted by parsePulseTrain() if compiled
+ * with PROTOCOL_STATS set to 1. Cycles are CPU cycles (ESP.getCycleCount())
+ * spent in the decoder functions.
+ */
+typedef struct PilightProtocolStats_t {
+  uint32_t validateCalls;
+  uint32_t validateAccepts;
+  uint32_t messages;
+  uint64_t validateCycles;
+  uint32_t validateMaxCycles;
+  uint64_t parseCycles;
+  uint32_t parseMaxCycles;
+} PilightProtocolStats_t;
+
+/**
+ * Receiver statistics collected by interruptHandler(). Edge durations are
+ * counted in log2 buckets: histogram[i] counts durations of 2^i up to
+ * 2^(i+1) - 1 us, the last bucket all longer ones. Durations are measured
+ * from the last accepted edge, so glitches below minpulselen add up.
+ */
+#define RECEIVER_STATS_BUCKETS 16
+
+typedef struct ReceiverStats_t {
+  uint32_t edges;
+  uint32_t histogram[RECEIVER_STATS_BUCKETS];
+  uint32_t belowMinPulse;  // edges ignored as glitch
+  uint32_t aboveMaxPulse;  // edges ending a too long pulse
+  uint32_t overruns;       // edges lost, all pulse train buffers in use
+  uint32_t isrCycles;      // CPU cycles spent in interruptHandler()
+  uint32_t isrMaxCycles;
+} ReceiverStats_t;
+
+/**
+ * Heap statistics of the pilight code (MALLOC etc.), collected if compiled
+ * with MEMORY_STATS. For an operation, peak is the maximum of the bytes in
+ * use above those at its start and retained the sum of bytes left in use,
+ * e.g. by a leak or a cache. For MEMORY_STATS_TOTAL, calls is 0 and peak
+ * and retained are the absolute values.
+ */
+enum MemoryStatsOperation_t {
+  MEMORY_STATS_TOTAL,
+  MEMORY_STATS_PARSE,
+  MEMORY_STATS_SEND,
+  MEMORY_STATS_LIMIT_PROTOCOLS,
+  MEMORY_STATS_OPERATIONS
+};
+
+typedef struct MemoryStats_t {
+  uint32_t calls;
+  uint32_t allocations;
+  uint32_t frees;
+  uint32_t bytes;
+  uint32_t peak;
+  int32_t retained;
+} MemoryStats_t;
+
+/**
+ * Transmit statistics. Airtime is the sum of the transmitted pulse lengths
+ * in us, of all transmissions (not only queued ones).
+ */
+typedef struct TransmitStats_t {
+  uint32_t queued;      // messages accepted by queue()
+  uint32_t superseded;  // queued messages replaced by a newer one
+  uint32_t sent;        // queued messages transmitted by loop()
+  uint32_t depth;       // messages waiting in the queue
+  uint32_t airtime;     // airtime of the current budget window
+  uint64_t totalAirtime;
+  uint32_t deferred;       // transmissions deferred by listen before talk
+  uint32_t deferTimeouts;  // of those, sent anyway after maxDefer
+  uint32_t deferTime;      // ms spent waiting for a clear channel
+  uint32_t jitterMax;      // ns, pulse length deviation of the last
+  uint32_t jitterMean;     // transmission from the requested lengths
+} TransmitStats_t;
+
+typedef struct PulseTrainCacheEntry_t {
+  String protocol;
+  String command;
+  uint16_t *pulses;
+  uint8_t length;
+  uint8_t txrpt;
+  int handle;
+  uint32_t lastUse;
+  uint32_t airtime;  // of one repeat, in us
+} PulseTrainCacheEntry_t;
+
+typedef struct TransmitQueueEntry_t {
+  String protocol;
+  String command;
+  String target;  // device addressed by command, see queue()
+  int handle;     // pulse train cache handle
+  size_t repeats;
+  uint32_t serial;  // queue order, 0 if unused
+} TransmitQueueEntry_t;
+
+/**
+ * Buffer size (including terminating null) for protocol ids copied by
+ * PilightMessage::protocol(), longer ids are truncated.
+ */
+#define PILIGHT_PROTOCOL_ID_SIZE 24
+
+struct JsonNode;
+
+/**
+ * Decoded message, passed to the PilightMessageCallBack. Nothing is
+ * formatted in advance: the protocol id, json text and device id are
+ * created on first access and kept until the callback returns. A message
+ * is only valid within the callback.
+ */
+class PilightMessage {
+ public:
+  PilightMessage(const char *protocolId, const JsonNode *message,
+                 PilightRepeatStatus_t status, size_t repeats);
+  ~PilightMessage();
+  PilightMessage(const PilightMessage &) = delete;
+  PilightMessage &operator=(const PilightMessage &) = delete;
+
+  /**
+   * Compare the protocol id without copying it (ids are kept in flash).
+   */
+  bool isProtocol(const char *protocol) const;
+
+  const char *protocol();
+  PilightRepeatStatus_t status() const { return _status; }
+  size_t repeats() const { return _repeats; }
+
+  /**
+   * Json text of the message, e.g. {"id":1234,"unit":1,"state":"on"}.
+   * Returns: nullptr if out of memory
+   */
+  const char *json();
+
+  /**
+   * Serialize the message as MessagePack into buffer, without heap
+   * allocation and number formatting. Object members are in the order of
+   * json(), integral numbers without decimals are integers.
+   * Returns: size of the encoding, it is truncated if this exceeds size
+   */
+  size_t msgpack(uint8_t *buffer, size_t size) const;
+
+  /**
+   * Value of the "id" member as string, or "" if there is none.
+   */
+  const char *deviceId();
+
+  /**
+   * Look up a numeric member of the message.
+   * Returns: false if there is no such member
+   */
+  bool number(const char *key, double *value) const;
+
+  /**
+   * Look up a string member of the message.
+   * Returns: nullptr if there is no such member
+   */
+  const char *string(const char *key) const;
+
+ private:
+  const char *_protocolId;
+  const JsonNode *_message;
+  PilightRepeatStatus_t _status;
+  size_t _repeats;
+  char *_json;
+  const char *_deviceId;
+  char _protocol[PILIGHT_PROTOCOL_ID_SIZE];
+  char _number[12];
+};
+
 typedef std::function<void(const String &protocol, const String &message,
                            int status, size_t repeats, const String &deviceID)>
     ESPiLightCallBack;
+/**
+ * Like ESPiLightCallBack, without constructing Strings. The strings are
+ * null terminated and only valid within the callback.
+ */
+typedef std::function<void(const char *protocol, const char *message,
+                           int status, size_t repeats, const char *deviceID)>
+    ESPiLightCStringCallBack;
+typedef std::function<void(PilightMessage &message)> PilightMessageCallBack;
 typedef std::function<void(const uint16_t *pulses, size_t length)>
     PulseTrainCallBack;
 
@@ -52,29 +276,139 @@ class ESPiLight {
    */
   ESPiLight(int8_t outputPin);
 
+  ~ESPiLight();
+  // the pulse train cache owns its buffers
+  ESPiLight(const ESPiLight &) = delete;
+  ESPiLight &operator=(const ESPiLight &) = delete;
+
   /**
    * Transmit pulse train
    */
   void sendPulseTrain(const uint16_t *pulses, size_t length,
                       size_t repeats = 10);
 
+  /**
+   * Transmit pulse train in binary encoding (see encodePulseTrain()).
+   * repeats of 0 means repeats as stored in data, or 10 if not stored.
+   * Returns: length of pulse train or ERROR_INVALID_PULSETRAIN_DATA
+   */
+  int sendEncodedPulseTrain(const uint8_t *data, size_t size,
+                            size_t repeats = 0);
+
   /**
    * Transmit Pilight json message
    * repeats of 0 means repeats as defined in protocol.
    */
   int send(const String &protocol, const String &json, size_t repeats = 0);
 
+  /**
+   * Transmit Pilight command given as parameter array, without json
+   * processing and heap allocation for the command. At most
+   * MAX_PILIGHT_PARAMS parameters are supported.
+   * repeats of 0 means repeats as defined in protocol.
+   */
+  int send(const char *protocol, const PilightParam_t *params, size_t count,
+           size_t repeats = 0);
+
+  /**
+   * Create the pulse train of a Pilight json message and keep it in the
+   * pulse train cache, to be replayed by sendCached() without running
+   * createCode() again. send() does not use the cache, as some protocols
+   * create a different pulse train on each call, e.g. a sequence number.
+   * Returns: handle (> 0) or an error code as createPulseTrain()
+   */
+  int cachePulseTrain(const String &protocol, const String &json);
+
+  /**
+   * Transmit a cached pulse train.
+   * repeats of 0 means repeats as defined in protocol.
+   * Returns: length of pulse train or an error code
+   */
+  int sendCached(int handle, size_t repeats = 0);
+
+  /**
+   * Drop cached pulse trains of a protocol, or all if protocol is empty.
+   * Handles of dropped pulse trains become invalid.
+   */
+  void invalidateCache(const String &protocol = "");
+
+  /**
+   * Queue a Pilight json message for transmission by loop(), at most one
+   * message per loop() call. A message still queued for the same target
+   * device is replaced by the new one, which keeps its place in the queue.
+   * The target is the protocol and the "id", "systemcode", "programcode",
+   * "unit", "unitcode", "channel" and "all" members of json.
+   * The pulse train is created once and cached, see cachePulseTrain().
+   * repeats of 0 means repeats as defined in protocol.
+   * Returns: number of queued messages or an error code as send(), or
+   * ERROR_QUEUE_FULL
+   */
+  int queue(const String &protocol, const String &json, size_t repeats = 0);
+
+  /**
+   * Limit the airtime of queued messages to airtime us per window of
+   * window ms. A message is deferred until it fits into the airtime left in
+   * the current window, a message exceeding the budget is sent alone in a
+   * window. All transmissions use up the budget. airtime of 0 disables the
+   * limit (default), the window (default 1000 ms) is used for the airtime
+   * statistics anyway.
+   */
+  void setAirtimeBudget(uint32_t airtime, uint32_t window = 1000);
+
+  /**
+   * Listen before talk: defer transmissions while the receiver is taking in
+   * a pulse train, i.e. the footer of a pulse train was received less than
+   * quiet us ago, or the last edge was received less than quiet us ago and
+   * followed at least pulses pulses. Isolated noise edges therefore do not
+   * block the channel. The transmission
+   * starts anyway after maxDefer ms. quiet of 0 disables it (default).
+   * Needs an enabled receiver (initReceiver()).
+   */
+  void setListenBeforeTalk(uint32_t quiet, uint32_t maxDefer = 500,
+                           uint8_t pulses = 8);
+
+  /**
+   * Get the transmit statistics.
+   */
+  void transmitStats(TransmitStats_t *stats);
+
+  /**
+   * Reset the transmit statistics, except the queue depth and the airtime
+   * of the current window.
+   */
+  void resetTransmitStats();
+
   /**
    * Parse pulse train and fire callback
    */
   size_t parsePulseTrain(uint16_t *pulses, uint8_t length);
 
   /**
-   * Process receiver queue and fire callback
+   * Number of protocols that decoded the last parsed pulse train, e.g. to
+   * be used within the PulseTrainCallBack.
+   */
+  size_t lastMatches() const;
+
+  /**
+   * Process receiver queue and fire callback, transmit the next queued
+   * message
    */
   void loop();
 
   void setCallback(ESPiLightCallBack callback);
+
+  /**
+   * Set a callback receiving a PilightMessage, which formats only the
+   * parts that are accessed.
+   */
+  void setMessageCallback(PilightMessageCallBack callback);
+
+  /**
+   * Set a callback receiving the message like ESPiLightCallBack, as C
+   * strings. If several callbacks are set, they are called in the order
+   * PilightMessageCallBack, ESPiLightCStringCallBack, ESPiLightCallBack.
+   */
+  void setCStringCallback(ESPiLightCStringCallBack callback);
   void setPulseTrainCallBack(PulseTrainCallBack rawCallback);
 
   /**
@@ -93,6 +427,20 @@ class ESPiLight {
    */
   static uint8_t receivePulseTrain(uint16_t *pulses);
 
+  /**
+   * Borrow the next PulseTrain in place from the receiver queue.
+   * The pulses stay valid and untouched by the receiver until
+   * releasePulseTrain() is called.
+   * Returns: pointer to the pulses or nullptr if not avaiable
+   */
+  static uint16_t *borrowPulseTrain(uint8_t *length);
+
+  /**
+   * Release the PulseTrain obtained by borrowPulseTrain() and free its
+   * queue slot for the receiver.
+   */
+  static void releasePulseTrain();
+
   /**
    * Check if new PulseTrain avaiable.
    * Returns: 0 if no new PulseTrain avaiable
@@ -117,6 +465,18 @@ class ESPiLight {
    */
   static void interruptHandler();
 
+  /**
+   * Get the statistics collected by interruptHandler(), if compiled with
+   * RECEIVER_STATS.
+   * Returns: false if statistics are not available
+   */
+  static bool receiverStats(ReceiverStats_t *stats);
+
+  /**
+   * Reset the statistics collected by interruptHandler().
+   */
+  static void resetReceiverStats();
+
   /**
    * Limit the available protocols.
    *
@@ -135,6 +495,41 @@ class ESPiLight {
    */
   static String enabledProtocols();
 
+  /**
+   * Get the decode statistics of a protocol, if compiled with
+   * PROTOCOL_STATS.
+   * Returns: false if the protocol is unknown or statistics are not
+   * available
+   */
+  static bool protocolStats(const String &protocol,
+                            PilightProtocolStats_t *stats);
+
+  /**
+   * Return a json object containing the decode statistics of all the
+   * currently enabled protocols, e.g.
+   * {"arctech_switch":{"validate_calls":12,"validate_accepts":4,...},...}
+   * or {} if not compiled with PROTOCOL_STATS.
+   */
+  static String protocolStats();
+
+  /**
+   * Reset the decode statistics of all protocols.
+   */
+  static void resetProtocolStats();
+
+  /**
+   * Get the heap statistics of an operation (parsePulseTrain(), send(),
+   * limitProtocols()) or the totals, if compiled with MEMORY_STATS.
+   * Returns: false if statistics are not available
+   */
+  static bool memoryStats(MemoryStats_t *stats,
+                          MemoryStatsOperation_t operation = MEMORY_STATS_TOTAL);
+
+  /**
+   * Reset the heap statistics, except the bytes currently in use.
+   */
+  static void resetMemoryStats();
+
   /**
    * Set pilight error output Print class (default is Serial)
    */
@@ -148,20 +543,54 @@ class ESPiLight {
   static uint16_t maxpulselen;
 
   static String pulseTrainToString(const uint16_t *pulses, size_t length);
+
+  /**
+   * Format pulse train like pilight USB Nano ("c:...;p:...@") into buffer
+   * without heap allocation. The string is truncated (but always null
+   * terminated) if buffer is too small.
+   * Returns: length of the complete string, a buffer of at least the
+   * returned value + 1 is needed, or ERROR_PULSETRAIN_PULSE_TYPES
+   */
+  static int pulseTrainToString(const uint16_t *pulses, size_t length,
+                                char *buffer, size_t size);
   static int stringToPulseTrain(const String &data, uint16_t *pulses,
                                 size_t maxlength);
   static int stringToRepeats(const String &data);
 
+  /**
+   * Encode pulse train in a compact binary format, pulses are clustered
+   * into pulse types like pulseTrainToString() does. At most
+   * MAXENCODEDPULSETRAINSIZE bytes are needed.
+   * repeats of 0 means no repeats are stored.
+   * Returns: number of bytes written to data or an error code
+   */
+  static int encodePulseTrain(const uint16_t *pulses, size_t length,
+                              uint8_t *data, size_t maxsize,
+                              uint8_t repeats = 0);
+
+  /**
+   * Decode pulse train from binary format (see encodePulseTrain()).
+   * Returns: length of pulse train or an error code
+   */
+  static int decodePulseTrain(const uint8_t *data, size_t size,
+                              uint16_t *pulses, size_t maxlength);
+
   static int createPulseTrain(uint16_t *pulses, const String &protocol_id,
                               const String &json);
+  static int createPulseTrain(uint16_t *pulses, const char *protocol_id,
+                              const char *json);
+  static int createPulseTrain(uint16_t *pulses, const char *protocol_id,
+                              const PilightParam_t *params, size_t count);
 
   /**
-   * Error return codes for send() and createPulseTrain()
+   * Error return codes for send(), queue() and createPulseTrain()
    */
   static const int ERROR_UNAVAILABLE_PROTOCOL = 0;
   static const int ERROR_INVALID_PILIGHT_MSG = -1;
   static const int ERROR_INVALID_JSON = -2;
   static const int ERROR_NO_OUTPUT_PIN = -3;
+  static const int ERROR_INVALID_HANDLE = -4;
+  static const int ERROR_QUEUE_FULL = -5;
 
   /**
    * Error return codes for stringToPulseTrain()
@@ -171,12 +600,46 @@ class ESPiLight {
   static const int ERROR_INVALID_PULSETRAIN_MSG_END = -3;
   static const int ERROR_INVALID_PULSETRAIN_MSG_TYPE = -4;
   static const int ERROR_INVALID_PULSETRAIN_MSG_R = -5;
+  static const int ERROR_INVALID_PULSETRAIN_MSG_LENGTH = -6;
+
+  /**
+   * Error return codes for encodePulseTrain(), decodePulseTrain() and
+   * sendEncodedPulseTrain()
+   */
+  static const int ERROR_PULSETRAIN_BUFFER_SIZE = -1;
+  static const int ERROR_PULSETRAIN_PULSE_TYPES = -2;
+  static const int ERROR_INVALID_PULSETRAIN_DATA = -3;
 
  private:
   ESPiLightCallBack _callback;
+  PilightMessageCallBack _messageCallback;
+  ESPiLightCStringCallBack _cstringCallback;
   PulseTrainCallBack _rawCallback;
   int8_t _outputPin;
   bool _echoEnabled;
+  size_t _lastMatches;
+  PulseTrainCacheEntry_t _cache[PULSETRAIN_CACHE_SIZE];
+  uint32_t _cacheClock;
+  int _cacheSerial;
+  TransmitQueueEntry_t _queue[TRANSMIT_QUEUE_SIZE];
+  uint32_t _queueSerial;
+  TransmitStats_t _transmitStats;
+  uint32_t _airtimeBudget;
+  uint32_t _airtimeWindow;
+  uint32_t _airtimeWindowStart;
+  uint32_t _lbtQuiet;
+  uint32_t _lbtMaxDefer;
+  uint8_t _lbtPulses;
+
+  PulseTrainCacheEntry_t *findCached(int handle);
+  bool airtimeAvailable(uint32_t airtime);
+  void countAirtime(uint32_t airtime);
+  bool channelBusy() const;
+  void countJitter(const struct EdgeTimer_t *timer);
+  void listenBeforeTalk();
+  template <typename PulseSource>
+  void transmit(const PulseSource &pulse, size_t length, size_t repeats);
+  void transmitQueued();
 
   /**
    * Quasi-reset. Called when the current edge is too long or short.
@@ -196,7 +659,87 @@ class ESPiLight {
   static uint8_t _avaiablePulseTrain;
   static volatile unsigned long _lastChange;  // Timestamp of previous edge
   static volatile uint8_t _nrpulses;
+  static volatile unsigned long _lastTrain;  // Timestamp of last footer
   static int16_t _interrupt;
+#if RECEIVER_STATS
+  static volatile ReceiverStats_t _receiverStats;
+#endif
+};
+
+/**
+ * Incremental parser for the pilight USB Nano string format
+ * ("c:...;p:...;r:...@"). Characters can be fed one by one, e.g. directly
+ * from a Stream, and pulses are written to the given buffer without any
+ * heap allocation. A complete pulse train stays valid until the next
+ * character is fed.
+ */
+class PulseTrainStringParser {
+ public:
+  PulseTrainStringParser(uint16_t *pulses, size_t maxlength);
+
+  /**
+   * Feed one character.
+   * Returns: true if a complete pulse train is available
+   */
+  bool parse(char c);
+
+  /**
+   * Feed all available characters of stream, stops after a complete pulse
+   * train.
+   * Returns: true if a complete pulse train is available
+   */
+  bool parse(Stream &stream);
+
+  /**
+   * Terminate the current message at the end of input, as if '@' was fed.
+   * Returns: true if a complete pulse train is available
+   */
+  bool finish();
+
+  /**
+   * Discard the current message.
+   */
+  void reset();
+
+  /**
+   * Length of the complete pulse train or 0.
+   */
+  size_t length() const { return _complete ? _length : 0; }
+
+  /**
+   * Repeats of the last complete pulse train or -1 if not given.
+   */
+  int repeats() const { return _repeats; }
+
+  /**
+   * Error code (see ESPiLight::stringToPulseTrain()) of the last invalid
+   * message or 0.
+   */
+  int error() const { return _error; }
+
+ private:
+  enum State_t { KEY, COLON, CODES, TYPES, REPEATS, SKIP, INVALID };
+
+  void fail(int error);
+  bool endSection();
+  bool endMessage();
+  bool pushNumber();
+
+  uint16_t *_pulses;
+  size_t _maxlength;
+  size_t _length;
+  uint16_t _plstypes[MAX_PULSE_TYPES];
+  uint8_t _nrtypes;
+  uint8_t _maxindex;
+  uint32_t _number;
+  bool _digits;
+  bool _codes;
+  bool _started;
+  bool _complete;
+  char _key;
+  int _repeats;
+  int _error;
+  State_t _state;
 };
 
 #endif
@@ -0,0 +1,117 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include <PulseTrainCapture.h>
+
+static const uint8_t capture_magic[] = {'E', 'P', 'L', 'C'};
+
+PulseTrainCaptureWriter::PulseTrainCaptureWriter(Print &output,
+                                                 uint8_t receiver)
+    : _output(output), _receiver(receiver) {}
+
+size_t PulseTrainCaptureWriter::writeHeader() {
+  uint8_t header[CAPTURE_HEADER_SIZE];
+
+  memcpy(header, capture_magic, sizeof(capture_magic));
+  header[4] = CAPTURE_VERSION;
+  return _output.write(header, sizeof(header));
+}
+
+size_t PulseTrainCaptureWriter::write(const uint16_t *pulses, size_t length,
+                                      int matches) {
+  if (length > MAXPULSESTREAMLENGTH) {
+    return 0;
+  }
+  return writeRecord((uint32_t)micros(), _receiver,
+                     (matches < 0 || matches >= CAPTURE_MATCHES_UNKNOWN)
+                         ? CAPTURE_MATCHES_UNKNOWN
+                         : (uint8_t)matches,
+                     pulses, (uint8_t)length);
+}
+
+size_t PulseTrainCaptureWriter::write(const PulseTrainCaptureRecord_t &record) {
+  return writeRecord(record.timestamp, record.receiver, record.matches,
+                     record.pulses, record.length);
+}
+
+size_t PulseTrainCaptureWriter::writeRecord(uint32_t timestamp,
+                                            uint8_t receiver, uint8_t matches,
+                                            const uint16_t *pulses,
+                                            uint8_t length) {
+  // pulses are written in chunks to keep the stack usage low
+  uint8_t buffer[64];
+  size_t count = 0;
+  size_t written = 0;
+
+  buffer[count++] = (uint8_t)timestamp;
+  buffer[count++] = (uint8_t)(timestamp >> 8);
+  buffer[count++] = (uint8_t)(timestamp >> 16);
+  buffer[count++] = (uint8_t)(timestamp >> 24);
+  buffer[count++] = receiver;
+  buffer[count++] = matches;
+  buffer[count++] = length;
+  for (uint8_t i = 0; i < length; i++) {
+    if (count + 2 > sizeof(buffer)) {
+      written += _output.write(buffer, count);
+      count = 0;
+    }
+    buffer[count++] = (uint8_t)pulses[i];
+    buffer[count++] = (uint8_t)(pulses[i] >> 8);
+  }
+  written += _output.write(buffer, count);
+  return written;
+}
+
+PulseTrainCaptureReader::PulseTrainCaptureReader(Stream &input)
+    : _input(input) {}
+
+bool PulseTrainCaptureReader::readHeader() {
+  uint8_t header[CAPTURE_HEADER_SIZE];
+
+  if (_input.readBytes(header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  return memcmp(header, capture_magic, sizeof(capture_magic)) == 0 &&
+         header[4] == CAPTURE_VERSION;
+}
+
+bool PulseTrainCaptureReader::read(PulseTrainCaptureRecord_t *record) {
+  uint8_t header[CAPTURE_RECORD_HEADER_SIZE];
+
+  if (_input.readBytes(header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  record->timestamp = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+                      ((uint32_t)header[2] << 16) |
+                      ((uint32_t)header[3] << 24);
+  record->receiver = header[4];
+  record->matches = header[5];
+  record->length = header[6];
+  // the log may be written by a build with a larger MAXPULSESTREAMLENGTH
+  if (record->length > MAXPULSESTREAMLENGTH) {
+    return false;
+  }
+  for (uint8_t i = 0; i < record->length; i++) {
+    uint8_t pulse[2];
+    if (_input.readBytes(pulse, sizeof(pulse)) != sizeof(pulse)) {
+      return false;
+    }
+    record->pulses[i] = (uint16_t)(pulse[0] | (pulse[1] << 8));
+  }
+  return true;
+}
@@ -0,0 +1,103 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef PULSETRAINCAPTURE_H
+#define PULSETRAINCAPTURE_H
+
+#include <ESPiLight.h>
+
+/**
+ * Capture log format, all values are little endian:
+ *
+ * header:  "EPLC" version(uint8_t)
+ * record:  timestamp(uint32_t, micros()) receiver(uint8_t)
+ *          matches(uint8_t) length(uint8_t) pulses(uint16_t[length])
+ *
+ * Records are appended, a log may be continued after a restart. matches is
+ * the number of protocols that decoded the pulse train at capture time or
+ * CAPTURE_MATCHES_UNKNOWN.
+ */
+#define CAPTURE_VERSION 1
+#define CAPTURE_HEADER_SIZE 5
+#define CAPTURE_RECORD_HEADER_SIZE 7
+#define CAPTURE_MATCHES_UNKNOWN 0xFF
+
+typedef struct PulseTrainCaptureRecord_t {
+  uint32_t timestamp;
+  uint8_t receiver;
+  uint8_t matches;
+  uint8_t length;
+  uint16_t pulses[MAXPULSESTREAMLENGTH];
+} PulseTrainCaptureRecord_t;
+
+class PulseTrainCaptureWriter {
+ public:
+  /**
+   * Constructor. receiver identifies the receiver in the written records.
+   */
+  PulseTrainCaptureWriter(Print &output, uint8_t receiver = 0);
+
+  /**
+   * Write the log header, only needed at the beginning of a new log.
+   * Returns: number of bytes written
+   */
+  size_t writeHeader();
+
+  /**
+   * Write a record of a pulse train captured now, e.g. from the
+   * PulseTrainCallBack. matches of -1 means unknown.
+   * Returns: number of bytes written
+   */
+  size_t write(const uint16_t *pulses, size_t length, int matches = -1);
+
+  /**
+   * Write a record.
+   * Returns: number of bytes written
+   */
+  size_t write(const PulseTrainCaptureRecord_t &record);
+
+ private:
+  size_t writeRecord(uint32_t timestamp, uint8_t receiver, uint8_t matches,
+                     const uint16_t *pulses, uint8_t length);
+
+  Print &_output;
+  uint8_t _receiver;
+};
+
+class PulseTrainCaptureReader {
+ public:
+  PulseTrainCaptureReader(Stream &input);
+
+  /**
+   * Read and check the log header.
+   * Returns: true if it is a supported capture log
+   */
+  bool readHeader();
+
+  /**
+   * Read the next record.
+   * Returns: false at the end of the log, on a truncated record or a
+   * record of more than MAXPULSESTREAMLENGTH pulses
+   */
+  bool read(PulseTrainCaptureRecord_t *record);
+
+ private:
+  Stream &_input;
+};
+
+#endif
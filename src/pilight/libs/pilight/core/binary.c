@@ -116,4 +116,16 @@ int binToSigned(const int *binary, int s, int e) { //  0<=s<=e, binary[s(lsb) ..
 		result -= 1<<(e-s+1);
 	}
 	return result;
-}
\ No newline at end of file
+}
+
+void decToBinRangeRev(int *binary, int s, int e, int value) { // binary[s(msb) .. e(lsb)]
+	unsigned int n = (unsigned int) value;
+	for(; e>=s; e--, n >>= 1)
+		binary[e] = n & 1;
+}
+
+void decToBinRange(int *binary, int s, int e, int value) { // binary[s(lsb) .. e(msb)]
+	unsigned int n = (unsigned int) value;
+	for(; s<=e; s++, n >>= 1)
+		binary[s] = n & 1;
+}
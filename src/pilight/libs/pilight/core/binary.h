@@ -88,4 +88,15 @@ int decToBinRevUl(unsigned long long n, int *binary);
 int binToSignedRev(const int *binary, int s, int e);    // 0<=s<=e, binary[s(msb) .. e(lsb)]
 int binToSigned(const int *binary, int s, int e);       // 0<=s<=e, binary[s(lsb) .. e(msb)]
 
+/*
+ * Store the e-s+1 least significant bits of value in binary[s] .. binary[e].
+ * The inverse of binToDecRev() and binToDec(): a value stored by decToBinRange[Rev]()
+ * reads back unchanged by binToDec[Rev](), a negative one by binToSigned[Rev]().
+ * @param binary The buffer of int where to store the "bits" (0 and 1).
+ * @param s, e Start+End index in the buffer of "bits". 0<=s<=e. e-s < sizeof(int)*8
+ * @param value The number to convert.
+ */
+void decToBinRangeRev(int *binary, int s, int e, int value);	// binary[s(msb) .. e(lsb)]
+void decToBinRange(int *binary, int s, int e, int value);	// binary[s(lsb) .. e(msb)]
+
 #endif
@@ -0,0 +1,152 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include "checksum.h"
+
+int binToNibblesRev(const int *binary, int s, int e, uint8_t *nibbles) {
+	int n = 0, x = 0;
+
+	for(x=s;x<=e;x++) {
+		if(((x-s)&3) == 0) {
+			nibbles[n++] = 0;
+		}
+		if(binary[x] != 0) {
+			nibbles[n-1] |= 0x8 >> ((x-s)&3);
+		}
+	}
+	return n;
+}
+
+int binToNibbles(const int *binary, int s, int e, uint8_t *nibbles) {
+	int n = 0, x = 0;
+
+	for(x=s;x<=e;x++) {
+		if(((x-s)&3) == 0) {
+			nibbles[n++] = 0;
+		}
+		if(binary[x] != 0) {
+			nibbles[n-1] |= 0x1 << ((x-s)&3);
+		}
+	}
+	return n;
+}
+
+int addNibbles(const uint8_t *nibbles, int n) {
+	int sum = 0, i = 0;
+
+	for(i=0;i<n;i++) {
+		sum += nibbles[i];
+	}
+	return sum;
+}
+
+uint8_t xorNibbles(const uint8_t *nibbles, int n) {
+	uint8_t result = 0;
+	int i = 0;
+
+	for(i=0;i<n;i++) {
+		result ^= nibbles[i];
+	}
+	return result;
+}
+
+/* one bit of a msb first CRC, the crc is kept in the msb of 8 bits */
+static uint8_t crcBit(uint8_t crc, int bit, uint8_t polynomial) {
+	if(((crc >> 7) ^ bit) & 1) {
+		return (uint8_t)((crc << 1) ^ polynomial);
+	}
+	return (uint8_t)(crc << 1);
+}
+
+/* one bit of a lsb first CRC */
+static uint8_t crcBitRev(uint8_t crc, int bit, uint8_t polynomial) {
+	if((crc ^ bit) & 1) {
+		return (uint8_t)((crc >> 1) ^ polynomial);
+	}
+	return (uint8_t)(crc >> 1);
+}
+
+void crcInit(struct crc_t *crc, uint8_t polynomial, int width) {
+	int i = 0, x = 0;
+
+	/* align msb first CRCs to 8 bits, so all widths share the code */
+	crc->polynomial = (uint8_t)(polynomial << (8-width));
+	crc->width = (uint8_t)width;
+	crc->reflected = 0;
+	for(i=0;i<16;i++) {
+		uint8_t value = (uint8_t)(i << 4);
+		for(x=0;x<4;x++) {
+			value = crcBit(value, 0, crc->polynomial);
+		}
+		crc->table[i] = value;
+	}
+}
+
+void crcInitRev(struct crc_t *crc, uint8_t polynomial, int width) {
+	int i = 0, x = 0;
+
+	crc->polynomial = polynomial;
+	crc->width = (uint8_t)width;
+	crc->reflected = 1;
+	for(i=0;i<16;i++) {
+		uint8_t value = (uint8_t)i;
+		for(x=0;x<4;x++) {
+			value = crcBitRev(value, 0, crc->polynomial);
+		}
+		crc->table[i] = value;
+	}
+}
+
+uint8_t crcNibbles(const struct crc_t *crc, const uint8_t *nibbles, int bits, uint8_t init) {
+	int n = bits / 4, rest = bits % 4, i = 0, x = 0;
+
+	if(crc->reflected) {
+		uint8_t value = init;
+		for(i=0;i<n;i++) {
+			value = (uint8_t)((value >> 4) ^ crc->table[(value ^ nibbles[i]) & 0xf]);
+		}
+		for(x=0;x<rest;x++) {
+			value = crcBitRev(value, (nibbles[n] >> x) & 1, crc->polynomial);
+		}
+		return value;
+	} else {
+		uint8_t value = (uint8_t)(init << (8-crc->width));
+		for(i=0;i<n;i++) {
+			value = (uint8_t)((value << 4) ^ crc->table[((value >> 4) ^ nibbles[i]) & 0xf]);
+		}
+		for(x=0;x<rest;x++) {
+			value = crcBit(value, (nibbles[n] >> (3-x)) & 1, crc->polynomial);
+		}
+		return (uint8_t)(value >> (8-crc->width));
+	}
+}
+
+uint8_t lfsrDigest(const uint8_t *nibbles, int n, uint8_t gen, uint8_t key) {
+	uint8_t sum = 0;
+	int i = 0, x = 0;
+
+	for(i=0;i<n;i++) {
+		for(x=3;x>=0;x--) {
+			if((nibbles[i] >> x) & 1) {
+				sum ^= key;
+			}
+			key = (uint8_t)((key & 1) ? (key >> 1) ^ gen : key >> 1);
+		}
+	}
+	return sum;
+}
@@ -0,0 +1,68 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _CHECKSUM_H_
+#define _CHECKSUM_H_
+
+#include <stdint.h>
+
+/*
+ * Pack "bits" (see binary.h) into nibbles, four bits per byte.
+ * The difference between binToNibblesRev() and binToNibbles() is the bit
+ * order, like binToDecRev() and binToDec(): binary[s] is the msb (Rev) or
+ * the lsb of nibbles[0]. An incomplete last nibble is filled up with 0 at
+ * its lsb (Rev) or msb.
+ * @return int The number of nibbles.
+ */
+int binToNibblesRev(const int *binary, int s, int e, uint8_t *nibbles);	// binary[s(msb) .. s+3(lsb)] -> nibbles[0]
+int binToNibbles(const int *binary, int s, int e, uint8_t *nibbles);		// binary[s(lsb) .. s+3(msb)] -> nibbles[0]
+
+/*
+ * Sum and xor of n nibbles.
+ */
+int addNibbles(const uint8_t *nibbles, int n);
+uint8_t xorNibbles(const uint8_t *nibbles, int n);
+
+/*
+ * Table-driven CRC of up to 8 bits, processed a nibble at a time.
+ * crcInit() prepares a msb first CRC (data packed by binToNibblesRev()),
+ * crcInitRev() a lsb first (reflected) CRC (data packed by binToNibbles()),
+ * polynomial given in the respective bit order, e.g. CRC-4 x^4+x+1 is 0x3
+ * or 0xc (reflected).
+ * crcNibbles() calculates the CRC over the first bits of nibbles, which
+ * does not need to be a multiple of four.
+ */
+struct crc_t {
+	uint8_t table[16];
+	uint8_t polynomial;
+	uint8_t width;
+	uint8_t reflected;
+};
+
+void crcInit(struct crc_t *crc, uint8_t polynomial, int width);
+void crcInitRev(struct crc_t *crc, uint8_t polynomial, int width);
+uint8_t crcNibbles(const struct crc_t *crc, const uint8_t *nibbles, int bits, uint8_t init);
+
+/*
+ * 8 bit LFSR digest of n nibbles, msb first (data packed by
+ * binToNibblesRev()): key is xored into the digest for every 1 bit and
+ * shifted right after every bit, xored with gen if a 1 drops out.
+ */
+uint8_t lfsrDigest(const uint8_t *nibbles, int n, uint8_t gen, uint8_t key);
+
+#endif
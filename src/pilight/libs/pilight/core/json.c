@@ -22,6 +22,7 @@
 */
 
 #include <assert.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -356,6 +357,9 @@ static JsonNode *mknode(JsonTag tag);
 static void append_node(JsonNode *parent, JsonNode *child);
 static void prepend_node(JsonNode *parent, JsonNode *child);
 static void append_member(JsonNode *object, char *key, JsonNode *value);
+static void set_member_key(JsonNode *node, const char *key);
+static const char *intern_key(const char *s, size_t len);
+static const char *parse_interned_key(const char **sp);
 
 /* Assertion-friendly validity checks */
 static bool tag_is_valid(unsigned int tag);
@@ -474,13 +478,56 @@ JsonNode *json_find_member(JsonNode *object, const char *name)
 	if (object == NULL || object->tag != JSON_OBJECT)
 		return NULL;
 
+	/* an interned key is mostly looked up by the same (merged) literal */
 	json_foreach(member, object)
-		if (strcmp(member->key, name) == 0)
+		if (member->key == name || strcmp(member->key, name) == 0)
 			return member;
 
 	return NULL;
 }
 
+/*
+ * The keys used by the protocols, sorted by strcmp(). Equal string literals
+ * are merged by the compiler and linker, so the literal key of a protocol
+ * usually is the pointer stored here.
+ */
+static const char *const interned_keys[] = {
+	"all", "battery", "binary", "button", "channel", "closed", "code",
+	"dawn", "dimlevel", "dimlevel-maximum", "dimlevel-minimum", "down",
+	"dusk", "humidity", "humidity-offset", "id", "learn", "num", "off",
+	"on", "opened", "programcode", "rain", "seq", "state", "super",
+	"systemcode", "tamper", "temperature", "temperature-decimals",
+	"temperature-offset", "unit", "unitcode", "up", "windavg", "winddir",
+	"windgust"
+};
+
+/* binary search for the len characters at s */
+static const char *intern_key(const char *s, size_t len)
+{
+	int lo = 0, hi = sizeof(interned_keys) / sizeof(interned_keys[0]) - 1;
+
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+		const char *key = interned_keys[mid];
+		int cmp = strncmp(s, key, len);
+
+		if (cmp == 0 && key[len] != '\0')
+			cmp = -1; /* s is a prefix of key */
+		if (cmp == 0)
+			return key;
+		if (cmp < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	return NULL;
+}
+
+const char *json_intern_key(const char *key)
+{
+	return intern_key(key, strlen(key));
+}
+
 JsonNode *json_first_child(const JsonNode *node)
 {
 	if (node != NULL && (node->tag == JSON_ARRAY || node->tag == JSON_OBJECT))
@@ -571,6 +618,18 @@ static void append_member(JsonNode *object, char *key, JsonNode *value)
 	append_node(object, value);
 }
 
+static void set_member_key(JsonNode *node, const char *key)
+{
+	const char *interned = json_intern_key(key);
+
+	if (interned != NULL) {
+		node->key = (char *) interned;
+		node->key_interned_ = true;
+	} else {
+		node->key = json_strdup(key);
+	}
+}
+
 void json_append_element(JsonNode *array, JsonNode *element)
 {
 	assert(array->tag == JSON_ARRAY);
@@ -592,7 +651,8 @@ void json_append_member(JsonNode *object, const char *key, JsonNode *value)
 	assert(object->tag == JSON_OBJECT);
 	assert(value->parent == NULL);
 
-	append_member(object, json_strdup(key), value);
+	set_member_key(value, key);
+	append_node(object, value);
 }
 
 void json_prepend_member(JsonNode *object, const char *key, JsonNode *value)
@@ -600,7 +660,7 @@ void json_prepend_member(JsonNode *object, const char *key, JsonNode *value)
 	assert(object->tag == JSON_OBJECT);
 	assert(value->parent == NULL);
 
-	value->key = json_strdup(key);
+	set_member_key(value, key);
 	prepend_node(object, value);
 }
 
@@ -618,13 +678,14 @@ void json_remove_from_parent(JsonNode *node)
 		else
 			parent->children.tail = node->prev;
 
-		if(node->key != NULL) {
+		if(node->key != NULL && !node->key_interned_) {
 			FREE(node->key);
 		}
 
 		node->parent = NULL;
 		node->prev = node->next = NULL;
 		node->key = NULL;
+		node->key_interned_ = false;
 	}
 }
 
@@ -748,6 +809,7 @@ static bool parse_object(const char **sp, JsonNode **out)
 	const char *s = *sp;
 	JsonNode *ret = out ? json_mkobject() : NULL;
 	char *key;
+	const char *interned = NULL;
 	JsonNode *value;
 
 	if (*s++ != '{')
@@ -760,7 +822,10 @@ static bool parse_object(const char **sp, JsonNode **out)
 	}
 
 	for (;;) {
-		if (!parse_string(&s, out ? &key : NULL))
+		interned = out ? parse_interned_key(&s) : NULL;
+		if (interned != NULL)
+			key = (char *) interned;
+		else if (!parse_string(&s, out ? &key : NULL))
 			goto failure;
 		skip_space(&s);
 
@@ -772,8 +837,10 @@ static bool parse_object(const char **sp, JsonNode **out)
 			goto failure_free_key;
 		skip_space(&s);
 
-		if (out)
+		if (out) {
 			append_member(ret, key, value);
+			value->key_interned_ = (interned != NULL);
+		}
 
 		if (*s == '}') {
 			s++;
@@ -792,13 +859,35 @@ success:
 	return true;
 
 failure_free_key:
-	if (out)
+	if (out && interned == NULL)
 		FREE(key);
 failure:
 	json_delete(ret);
 	return false;
 }
 
+/*
+ * Consume an object key without escapes when it is interned.
+ * Returns the interned key or NULL, leaving *sp untouched.
+ */
+static const char *parse_interned_key(const char **sp)
+{
+	const char *s = *sp;
+	const char *end;
+	const char *key;
+
+	if (*s != '"')
+		return NULL;
+	end = strpbrk(s + 1, "\"\\");
+	if (end == NULL || *end != '"')
+		return NULL;
+
+	key = intern_key(s + 1, (size_t)(end - s - 1));
+	if (key != NULL)
+		*sp = end + 1;
+	return key;
+}
+
 bool parse_string(const char **sp, char **out)
 {
 	const char *s = *sp;
@@ -1261,8 +1350,57 @@ void emit_string(SB *out, const char *str)
 	out->cur = b;
 }
 
+/*
+ * Print num with the given decimals using integer arithmetic, like
+ * sprintf("%.*f") would, which is slow on targets without FPU. Returns
+ * false if num is out of range or (almost) a tie between two roundings,
+ * as those have to be printed by sprintf to get exactly the same result.
+ */
+static bool emit_fixed_number(SB *out, double num, int decimals)
+{
+	static const unsigned long pow10[] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+	};
+	char buf[16];
+	char *p = &buf[sizeof(buf) - 1];
+	double scaled, frac;
+	unsigned long value;
+	int i;
+
+	if (decimals < 0 || decimals > 9)
+		return false;
+	scaled = fabs(num) * pow10[decimals];
+	if (!(scaled < 4294967295.0))
+		return false;
+	value = (unsigned long)scaled;
+	frac = scaled - value;
+	if (fabs(frac - 0.5) < 1e-5)
+		return false;
+	if (frac > 0.5)
+		value++;
+
+	*p = '\0';
+	for (i = 0; i < decimals; i++) {
+		*--p = (char)('0' + value % 10);
+		value /= 10;
+	}
+	if (decimals > 0)
+		*--p = '.';
+	do {
+		*--p = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	if (signbit(num))
+		*--p = '-';
+	sb_puts(out, p);
+	return true;
+}
+
 static void emit_number(SB *out, double num, int decimals)
 {
+	if (emit_fixed_number(out, num, decimals))
+		return;
+
 	/*
 	 * This isn't exactly how JavaScript renders numbers,
 	 * but it should produce valid JSON for reasonable numbers
@@ -1441,12 +1579,82 @@ void json_free(void *a) {
 	FREE(a);
 }
 
+JsonNode *json_copy(const JsonNode *node) {
+	JsonNode *ret = NULL, *child = NULL, *copy = NULL;
+
+	if(node == NULL) {
+		return NULL;
+	}
+
+	ret = mknode(node->tag);
+	switch(node->tag) {
+		case JSON_BOOL:
+			ret->bool_ = node->bool_;
+			break;
+		case JSON_STRING:
+			ret->string_ = json_strdup(node->string_);
+			break;
+		case JSON_NUMBER:
+			ret->number_ = node->number_;
+			ret->decimals_ = node->decimals_;
+			break;
+		case JSON_ARRAY:
+		case JSON_OBJECT:
+			for(child = node->children.head; child != NULL; child = child->next) {
+				copy = json_copy(child);
+				if(child->key_interned_) {
+					copy->key = child->key;
+					copy->key_interned_ = true;
+				} else if(child->key != NULL) {
+					copy->key = json_strdup(child->key);
+				}
+				append_node(ret, copy);
+			}
+			break;
+		default:;
+	}
+	return ret;
+}
+
 int json_clone(struct JsonNode *a, struct JsonNode **b) {
 	if(*b != NULL) {
 		json_delete(*b);
 	}
-	char *out = json_stringify(a, NULL);
-	*b = json_decode(out);
-	json_free(out);
+	*b = json_copy(a);
 	return 0;
 }
+
+bool json_equal(const JsonNode *a, const JsonNode *b) {
+	const JsonNode *x = NULL, *y = NULL;
+
+	if(a == b) {
+		return true;
+	}
+	if(a == NULL || b == NULL || a->tag != b->tag) {
+		return false;
+	}
+
+	switch(a->tag) {
+		case JSON_BOOL:
+			return a->bool_ == b->bool_;
+		case JSON_STRING:
+			return strcmp(a->string_, b->string_) == 0;
+		case JSON_NUMBER:
+			return a->number_ == b->number_ && a->decimals_ == b->decimals_;
+		case JSON_ARRAY:
+		case JSON_OBJECT:
+			for(x = a->children.head, y = b->children.head;
+			    x != NULL && y != NULL; x = x->next, y = y->next) {
+				if(x->key != y->key &&
+				   (x->key == NULL || y->key == NULL || strcmp(x->key, y->key) != 0)) {
+					return false;
+				}
+				if(!json_equal(x, y)) {
+					return false;
+				}
+			}
+			return x == NULL && y == NULL;
+		default:
+			return true;
+	}
+}
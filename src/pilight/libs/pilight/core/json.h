@@ -49,6 +49,7 @@ struct JsonNode
 	char *key; /* Must be valid UTF-8. */
 
 	JsonTag tag;
+	bool key_interned_; /* key is not owned, see json_intern_key() */
 	union {
 		/* JSON_BOOL */
 		bool bool_;
@@ -85,6 +86,13 @@ JsonNode   *json_find_member    (JsonNode *object, const char *key);
 
 JsonNode   *json_first_child    (const JsonNode *node);
 
+/*
+ * ESPiLight special: the member keys used by the protocols are interned,
+ * members share the static string instead of a copy. Returns the interned
+ * string equal to key or NULL.
+ */
+const char *json_intern_key     (const char *key);
+
 #define json_foreach(i, object_or_array)            \
 	for ((i) = json_first_child(object_or_array);   \
 		 (i) != NULL;                               \
@@ -121,7 +129,11 @@ bool json_check(const JsonNode *node, char errmsg[256]);
 int json_find_number(JsonNode *object, const char *name, double *out);
 int json_find_string(JsonNode *object, const char *name, char **out);
 
+/* Deep copy of node and its descendents, without the key of node itself */
+JsonNode *json_copy(const JsonNode *node);
 int json_clone(struct JsonNode *a, struct JsonNode **b);
+/* Structural comparison, members have to be in the same order */
+bool json_equal(const JsonNode *a, const JsonNode *b);
 
 bool utf8_validate(const char *s);
 
@@ -51,4 +51,6 @@ char *___strdup(char *, const char *, int);
 // #define _STRDUP strdup
 // #define _FREE free
 
+#include "../../../../tools/memtrack.h"
+
 #endif
@@ -0,0 +1,155 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+
+#include "msgpack.h"
+
+struct msgpack_writer_t {
+	uint8_t *buffer;
+	size_t size;
+	size_t length;
+};
+
+static void put(struct msgpack_writer_t *w, uint8_t byte) {
+	if(w->length < w->size) {
+		w->buffer[w->length] = byte;
+	}
+	w->length++;
+}
+
+/* type byte followed by n bytes of value, big endian */
+static void put_be(struct msgpack_writer_t *w, uint8_t type, uint64_t value, int n) {
+	put(w, type);
+	while(n-- > 0) {
+		put(w, (uint8_t)(value >> (8 * n)));
+	}
+}
+
+static void put_length(struct msgpack_writer_t *w, size_t length, uint8_t fix, size_t fixmax, uint8_t type8, uint8_t type16, uint8_t type32) {
+	if(length <= fixmax) {
+		put(w, (uint8_t)(fix | length));
+	} else if(length <= 0xff && type8 != 0) {
+		put_be(w, type8, length, 1);
+	} else if(length <= 0xffff) {
+		put_be(w, type16, length, 2);
+	} else {
+		put_be(w, type32, length, 4);
+	}
+}
+
+static void put_string(struct msgpack_writer_t *w, const char *s) {
+	size_t length = strlen(s), i = 0;
+
+	put_length(w, length, 0xa0, 31, 0xd9, 0xda, 0xdb);
+	for(i=0;i<length;i++) {
+		put(w, (uint8_t)s[i]);
+	}
+}
+
+static void put_int(struct msgpack_writer_t *w, int64_t value) {
+	if(value >= 0) {
+		if(value <= 0x7f) {
+			put(w, (uint8_t)value);
+		} else if(value <= 0xff) {
+			put_be(w, 0xcc, (uint64_t)value, 1);
+		} else if(value <= 0xffff) {
+			put_be(w, 0xcd, (uint64_t)value, 2);
+		} else if(value <= 0xffffffffLL) {
+			put_be(w, 0xce, (uint64_t)value, 4);
+		} else {
+			put_be(w, 0xcf, (uint64_t)value, 8);
+		}
+	} else {
+		if(value >= -32) {
+			put(w, (uint8_t)value);
+		} else if(value >= -0x80) {
+			put_be(w, 0xd0, (uint64_t)value, 1);
+		} else if(value >= -0x8000) {
+			put_be(w, 0xd1, (uint64_t)value, 2);
+		} else if(value >= -0x80000000LL) {
+			put_be(w, 0xd2, (uint64_t)value, 4);
+		} else {
+			put_be(w, 0xd3, (uint64_t)value, 8);
+		}
+	}
+}
+
+static void put_number(struct msgpack_writer_t *w, double value, int decimals) {
+	float f = (float)value;
+	uint32_t u32 = 0;
+	uint64_t u64 = 0;
+
+	/* the range check also rejects NaN */
+	if(decimals == 0 && value >= -9223372036854775808.0 && value < 9223372036854775808.0 &&
+	   (double)(int64_t)value == value) {
+		put_int(w, (int64_t)value);
+	} else if((double)f == value) {
+		memcpy(&u32, &f, sizeof(u32));
+		put_be(w, 0xca, u32, 4);
+	} else {
+		memcpy(&u64, &value, sizeof(u64));
+		put_be(w, 0xcb, u64, 8);
+	}
+}
+
+static void put_node(struct msgpack_writer_t *w, const JsonNode *node) {
+	const JsonNode *child = NULL;
+	size_t n = 0;
+
+	switch(node->tag) {
+		case JSON_BOOL:
+			put(w, node->bool_ ? 0xc3 : 0xc2);
+			break;
+		case JSON_STRING:
+			put_string(w, node->string_);
+			break;
+		case JSON_NUMBER:
+			put_number(w, node->number_, node->decimals_);
+			break;
+		case JSON_ARRAY:
+		case JSON_OBJECT:
+			for(child = node->children.head; child != NULL; child = child->next) {
+				n++;
+			}
+			if(node->tag == JSON_ARRAY) {
+				put_length(w, n, 0x90, 15, 0, 0xdc, 0xdd);
+			} else {
+				put_length(w, n, 0x80, 15, 0, 0xde, 0xdf);
+			}
+			for(child = node->children.head; child != NULL; child = child->next) {
+				if(node->tag == JSON_OBJECT) {
+					put_string(w, child->key);
+				}
+				put_node(w, child);
+			}
+			break;
+		default:
+			put(w, 0xc0);
+			break;
+	}
+}
+
+size_t json_msgpack(const JsonNode *node, uint8_t *buffer, size_t size) {
+	struct msgpack_writer_t w = { buffer, size, 0 };
+
+	if(node != NULL) {
+		put_node(&w, node);
+	}
+	return w.length;
+}
@@ -0,0 +1,36 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _MSGPACK_H_
+#define _MSGPACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "json.h"
+
+/*
+ * Serialize node as MessagePack into buffer, without writing beyond size.
+ * Numbers without decimals are written as integers if they are integral,
+ * other numbers as float 32 if that is exact or else as float 64. Object
+ * members keep their order.
+ * @return size_t The size of the complete encoding, it is truncated if
+ * this exceeds size.
+ */
+size_t json_msgpack(const JsonNode *node, uint8_t *buffer, size_t size);
+
+#endif
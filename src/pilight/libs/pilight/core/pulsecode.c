@@ -0,0 +1,177 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include "binary.h"
+#include "pulsecode.h"
+
+/* bits packed by one pulsecodePack() call of pulsecodeBits() */
+#define PULSECODE_CHUNK	256
+
+int pulsecodeBits(const struct pulsecode_t *code, const uint16_t *raw, int rawlen, int *binary) {
+	uint32_t bits[PULSECODE_CHUNK/32];
+	int one = (code->inverted == 0), zero = !one, n = 0, x = 0, i = 0, len = 0;
+
+	/* one bit per symbol starting within header..rawlen-footer-1 */
+	if(rawlen-code->footer > code->header) {
+		n = (rawlen-code->footer-code->header+code->width-1)/code->width;
+	}
+	for(x=0;x<n;x+=len) {
+		len = (n-x < PULSECODE_CHUNK) ? n-x : PULSECODE_CHUNK;
+		pulsecodePack(&raw[code->header+x*code->width+code->pulse], len, code->width, (uint16_t)code->threshold, bits);
+		for(i=0;i<len;i++) {
+			binary[x+i] = ((bits[i/32] >> (i%32)) & 1) ? one : zero;
+		}
+	}
+	return n;
+}
+
+int pulsecodeParse(const struct pulsecode_t *code, const uint16_t *raw, int rawlen, int *binary, int *values) {
+	const struct pulsecode_field_t *field = code->fields;
+	int n = pulsecodeBits(code, raw, rawlen, binary), x = 0;
+
+	for(x=0;x<code->nrfields;x++, field++) {
+		if(field->end >= n) {
+			values[x] = -1;
+		} else if(field->rev != 0) {
+			values[x] = binToDecRev(binary, field->start, field->end);
+		} else {
+			values[x] = binToDec(binary, field->start, field->end);
+		}
+	}
+	return n;
+}
+
+#if PULSECODE_KERNEL == PULSECODE_SSE2
+#include <emmintrin.h>
+
+/* bit j: raw[j] > threshold, for j = 0..15 */
+static uint32_t pulseMask16(const uint16_t *raw, uint16_t threshold) {
+	/* there is no unsigned 16 bit compare, so flip the sign bits */
+	const __m128i sign = _mm_set1_epi16((short)0x8000);
+	const __m128i t = _mm_xor_si128(_mm_set1_epi16((short)threshold), sign);
+	__m128i a = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&raw[0]), sign);
+	__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&raw[8]), sign);
+
+	a = _mm_cmpgt_epi16(a, t);
+	b = _mm_cmpgt_epi16(b, t);
+	return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(a, b));
+}
+#elif PULSECODE_KERNEL == PULSECODE_NEON
+#include <arm_neon.h>
+
+static uint32_t pulseMask8(const uint16_t *raw, uint16x8_t t) {
+	const uint8x8_t weights = vcreate_u8(0x8040201008040201ULL);
+	uint8x8_t gt = vmovn_u16(vcgtq_u16(vld1q_u16(raw), t));
+
+	return vaddv_u8(vand_u8(gt, weights));
+}
+
+/* bit j: raw[j] > threshold, for j = 0..15 */
+static uint32_t pulseMask16(const uint16_t *raw, uint16_t threshold) {
+	uint16x8_t t = vdupq_n_u16(threshold);
+
+	return pulseMask8(&raw[0], t) | (pulseMask8(&raw[8], t) << 8);
+}
+#endif
+
+#if PULSECODE_KERNEL == PULSECODE_SSE2 || PULSECODE_KERNEL == PULSECODE_NEON
+/* keep every stride-th bit of the 16 bit mask, packed to the lsb */
+static uint32_t compressMask16(uint32_t m, int stride) {
+	switch(stride) {
+		case 2:
+			m &= 0x5555;
+			m = (m | (m >> 1)) & 0x3333;
+			m = (m | (m >> 2)) & 0x0f0f;
+			m = (m | (m >> 4)) & 0x00ff;
+		break;
+		case 4:
+			m &= 0x1111;
+			m = (m | (m >> 3)) & 0x0303;
+			m = (m | (m >> 6)) & 0x000f;
+		break;
+		default:
+		break;
+	}
+	return m;
+}
+#endif
+
+int pulsecodePack(const uint16_t *raw, int n, int stride, uint16_t threshold, uint32_t *bits) {
+	uint32_t word = 0;
+	int i = 0, w = 0, nbits = 0;
+
+	if(n <= 0) {
+		return 0;
+	}
+
+#if PULSECODE_KERNEL == PULSECODE_SSE2 || PULSECODE_KERNEL == PULSECODE_NEON
+	if(stride == 1 || stride == 2 || stride == 4) {
+		/* a block reads 16 pulses, the last one at most raw[(n-1)*stride] */
+		int per = 16/stride, last = (n-1)*stride;
+
+		for(;i*stride+15<=last;i+=per) {
+			word |= compressMask16(pulseMask16(&raw[i*stride], threshold), stride) << nbits;
+			nbits += per;
+			if(nbits == 32) {
+				bits[w++] = word;
+				word = 0;
+				nbits = 0;
+			}
+		}
+	}
+#elif PULSECODE_KERNEL == PULSECODE_SWAR
+	if(threshold < 0xffff) {
+		/*
+		 * Two pulses per word, a >= threshold+1 in each 16 bit lane: the
+		 * low 15 bits are compared by a subtraction that cannot borrow from
+		 * the next lane, the top bits decide where they differ.
+		 */
+		const uint32_t high = 0x80008000;
+		uint32_t t = (uint32_t)threshold+1;
+
+		t |= t << 16;
+		for(;i+1<n;i+=2) {
+			uint32_t a = raw[i*stride] | ((uint32_t)raw[(i+1)*stride] << 16);
+			uint32_t d = (a | high) - (t & ~high);
+			uint32_t ge = ((a & ~t) | (~(a ^ t) & d)) & high;
+
+			word |= ((ge >> 15) & 1) << nbits;
+			word |= (ge >> 31) << (nbits+1);
+			nbits += 2;
+			if(nbits == 32) {
+				bits[w++] = word;
+				word = 0;
+				nbits = 0;
+			}
+		}
+	}
+#endif
+
+	for(;i<n;i++) {
+		word |= (uint32_t)(raw[i*stride] > threshold) << nbits;
+		if(++nbits == 32) {
+			bits[w++] = word;
+			word = 0;
+			nbits = 0;
+		}
+	}
+	if(nbits > 0) {
+		bits[w++] = word;
+	}
+	return w;
+}
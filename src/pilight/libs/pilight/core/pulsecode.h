@@ -0,0 +1,96 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _PULSECODE_H_
+#define _PULSECODE_H_
+
+#include <stdint.h>
+
+/*
+ * Declarative decoding of pulse width coded protocols.
+ * A pulse train is a header, a run of symbols of "width" pulses each and
+ * a footer. Every symbol carries one bit in the length of one of its
+ * pulses: "pulse" is the index of that pulse within the symbol and the
+ * bit is 1 if it is longer than "threshold" (0 if "inverted").
+ * The fields describe the values carried by the bits, each from binary[start]
+ * to binary[end], read by binToDecRev() if "rev" is set or else by binToDec().
+ */
+struct pulsecode_field_t {
+	int start;
+	int end;
+	int rev;
+};
+
+struct pulsecode_t {
+	int header;
+	int footer;
+	int width;
+	int pulse;
+	int threshold;
+	int inverted;
+	const struct pulsecode_field_t *fields;
+	int nrfields;
+};
+
+/*
+ * Slice the symbols of raw into binary, one int per bit, with the carrying
+ * pulses compared by pulsecodePack().
+ * The caller has to check rawlen against the size of binary.
+ * @return int The number of bits.
+ */
+int pulsecodeBits(const struct pulsecode_t *code, const uint16_t *raw, int rawlen, int *binary);
+
+/*
+ * Like pulsecodeBits() and extract the fields into values, in the order of
+ * code->fields. A field beyond the decoded bits is set to -1.
+ * @return int The number of bits.
+ */
+int pulsecodeParse(const struct pulsecode_t *code, const uint16_t *raw, int rawlen, int *binary, int *values);
+
+/*
+ * Kernel of pulsecodePack(), chosen by the target unless PULSECODE_KERNEL is
+ * defined: SSE2 on x86, NEON on aarch64 and scalar elsewhere. SWAR (two
+ * pulses per 32 bit word) has to be selected explicitly: it needs two 16 bit
+ * loads and about six operations per pair, so it is not known to beat the
+ * scalar compare on Xtensa without a cycle count on the ESP8266.
+ */
+#define PULSECODE_SCALAR	0
+#define PULSECODE_SWAR		1
+#define PULSECODE_SSE2		2
+#define PULSECODE_NEON		3
+
+#ifndef PULSECODE_KERNEL
+	#if defined(__SSE2__)
+		#define PULSECODE_KERNEL	PULSECODE_SSE2
+	#elif defined(__aarch64__) && defined(__ARM_NEON)
+		#define PULSECODE_KERNEL	PULSECODE_NEON
+	#else
+		#define PULSECODE_KERNEL	PULSECODE_SCALAR
+	#endif
+#endif
+
+/*
+ * Compare the n pulses raw[0], raw[stride], .. raw[(n-1)*stride] against
+ * threshold and pack the results into a bit vector: bit i%32 of bits[i/32]
+ * is 1 if raw[i*stride] > threshold. Strides of 1, 2 and 4 use the vector
+ * kernels, others the scalar or SWAR loop.
+ * @return int The number of words written to bits, (n+31)/32.
+ */
+int pulsecodePack(const uint16_t *raw, int n, int stride, uint16_t threshold, uint32_t *bits);
+
+#endif
@@ -66,6 +66,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/checksum.h"
 #include "../../core/gc.h"
 #include "acurite.h"
 
@@ -75,6 +76,13 @@
 #define MAX_PULSE_LENGTH 1100
 #define MIN_RAW_LENGTH 170
 #define MAX_RAW_LENGTH 200
+#define SYNC_PULSE_LENGTH 1200
+#define BIT_PULSE_LENGTH 1000
+#define ZERO_GAP_LENGTH 520
+#define ONE_GAP_LENGTH 780
+#define PACKET_BITS 40
+#define PACKET_LENGTH (8 + PACKET_BITS * 2)
+#define PACKETS 2
 
 typedef struct settings_t
 {
@@ -90,6 +98,7 @@ typedef struct settings_t
 } settings_t;
 
 static struct settings_t *settings = NULL;
+static struct crc_t packet_crc;
 
 static int validate(void)
 {
@@ -118,6 +127,14 @@ static int validate(void)
     return -1;
 }
 
+static void createMessage(double id, double temperature, int battery)
+{
+    acurite->message = json_mkobject();
+    json_append_member(acurite->message, "id", json_mknumber(id, 1));
+    json_append_member(acurite->message, "temperature", json_mknumber(temperature, 1));
+    json_append_member(acurite->message, "battery", json_mknumber(battery, 0));
+}
+
 static void parseCode(void)
 {
     int i = 0, x = 0, binary[MAX_RAW_LENGTH / 2];
@@ -216,13 +233,11 @@ static void parseCode(void)
     }
     */
 
-    acurite->message = json_mkobject();
-    json_append_member(acurite->message, "id", json_mknumber(id, 1));
-    json_append_member(acurite->message, "temperature", json_mknumber(temperature, 1));
-    json_append_member(acurite->message, "battery", json_mknumber(battery, 0));
+    createMessage(id, temperature, battery);
 
     acurite->repeats = 1; // Kludge for the the signal repeating in the pulse train
-    acurite->old_content = json_encode(acurite->message);
+    json_delete(acurite->old_message);
+    acurite->old_message = json_copy(acurite->message);
 }
 
 static int checkValues(struct JsonNode *jvalues)
@@ -299,6 +314,114 @@ static void gc(void)
     }
 }
 
+// Every bit takes BIT_PULSE_LENGTH so validate() accepts the pulse train whatever its content
+static void createLow(int s, int e)
+{
+    int i;
+
+    for (i = s; i <= e; i += 2)
+    {
+        acurite->raw[i] = BIT_PULSE_LENGTH - ZERO_GAP_LENGTH;
+        acurite->raw[i + 1] = ZERO_GAP_LENGTH;
+    }
+}
+
+static void createHigh(int s, int e)
+{
+    int i;
+
+    for (i = s; i <= e; i += 2)
+    {
+        acurite->raw[i] = BIT_PULSE_LENGTH - ONE_GAP_LENGTH;
+        acurite->raw[i + 1] = ONE_GAP_LENGTH;
+    }
+}
+
+static void createSync(int s)
+{
+    int i;
+
+    for (i = s; i < s + 8; i++)
+    {
+        acurite->raw[i] = SYNC_PULSE_LENGTH;
+    }
+}
+
+static void createFooter(void)
+{
+    // The gap of the last bit doubles as footer, like on the real sensor
+    acurite->raw[acurite->rawlen - 1] = PULSE_DIV * AVG_PULSE_LENGTH;
+}
+
+static int createCode(struct JsonNode *code)
+{
+    int binary[PACKET_BITS];
+    uint8_t nibbles[8];
+    int i = 0, x = 0, unit = 0, fahrenheit = 0;
+    double id = -1, temperature = 0.0, battery = 0;
+
+    if (json_find_number(code, "id", &id) != 0 || json_find_number(code, "temperature", &temperature) != 0)
+    {
+        logprintf(LOG_ERR, "acurite: insufficient number of arguments");
+        return EXIT_FAILURE;
+    }
+    json_find_number(code, "battery", &battery);
+
+    // The decimal of the id selects the second sensor, see parseCode()
+    unit = (int)round((id - floor(id)) * 10);
+    fahrenheit = (int)round(temperature * 9 / 5 + 32);
+
+    if (id < 0 || id >= 512 || unit > 1)
+    {
+        logprintf(LOG_ERR, "acurite: invalid id range");
+        return EXIT_FAILURE;
+    }
+    if (fahrenheit < -128 || fahrenheit > 127)
+    {
+        logprintf(LOG_ERR, "acurite: invalid temperature range");
+        return EXIT_FAILURE;
+    }
+
+    memset(binary, 0, sizeof(binary));
+    decToBinRange(binary, 0, 7, fahrenheit);
+    decToBinRange(binary, 8, 16, (int)floor(id));
+    binary[24] = unit;
+    binary[25] = (battery != 0);
+
+    // CRC-8 poly 0x07, little-endian, over the first four bytes
+    binToNibbles(binary, 0, 31, nibbles);
+    decToBinRange(binary, 32, 39, crcNibbles(&packet_crc, nibbles, 32, 0));
+
+    createMessage(floor(id) + ((double)unit) / 10, F2C((double)fahrenheit), (battery != 0));
+
+    acurite->rawlen = PACKETS * PACKET_LENGTH;
+    for (x = 0; x < acurite->rawlen; x += PACKET_LENGTH)
+    {
+        createSync(x);
+        for (i = 0; i < PACKET_BITS; i++)
+        {
+            if (binary[i] == 1)
+            {
+                createHigh(x + 8 + i * 2, x + 9 + i * 2);
+            }
+            else
+            {
+                createLow(x + 8 + i * 2, x + 9 + i * 2);
+            }
+        }
+    }
+    createFooter();
+
+    return EXIT_SUCCESS;
+}
+
+static void printHelp(void)
+{
+    printf("\t -i --id=id\t\t\tsend as the sensor with this id, add .1 for the second sensor\n");
+    printf("\t -t --temperature=temperature\tsend this temperature\n");
+    printf("\t -b --battery=battery\t\tsend a low battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -326,7 +449,11 @@ acuriteInit(void)
     options_add(&acurite->options, "0", "show-temperature", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
     options_add(&acurite->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
+    crcInitRev(&packet_crc, 0xe0, 8);
+
     acurite->parseCode = &parseCode;
+    acurite->createCode = &createCode;
+    acurite->printHelp = &printHelp;
     acurite->checkValues = &checkValues;
     acurite->validate = &validate;
     acurite->gc = &gc;
@@ -56,6 +56,14 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id, double temperature, double humidity, int battery) {
+	alecto_ws1700->message = json_mkobject();
+	json_append_member(alecto_ws1700->message, "id", json_mknumber(id, 0));
+	json_append_member(alecto_ws1700->message, "temperature", json_mknumber(temperature, 1));
+	json_append_member(alecto_ws1700->message, "humidity", json_mknumber(humidity, 1));
+	json_append_member(alecto_ws1700->message, "battery", json_mknumber(battery, 0));
+}
+
 static void parseCode(void) {
 	int i = 0, x = 0, binary[RAW_LENGTH/2];
 	int id = 0, battery = 0, header = 0;
@@ -99,11 +107,7 @@ static void parseCode(void) {
 	temperature += temp_offset;
 	humidity += humi_offset;
 
-	alecto_ws1700->message = json_mkobject();
-	json_append_member(alecto_ws1700->message, "id", json_mknumber(id, 0));
-	json_append_member(alecto_ws1700->message, "temperature", json_mknumber(temperature, 1));
-	json_append_member(alecto_ws1700->message, "humidity", json_mknumber(humidity, 1));
-	json_append_member(alecto_ws1700->message, "battery", json_mknumber(battery, 0));
+	createMessage(id, temperature, humidity, battery);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -168,6 +172,85 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		alecto_ws1700->raw[i]=(AVG_PULSE_LENGTH);
+		alecto_ws1700->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER/4);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		alecto_ws1700->raw[i]=(AVG_PULSE_LENGTH);
+		alecto_ws1700->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3/4);
+	}
+}
+
+static void createFooter(void) {
+	alecto_ws1700->raw[72]=(AVG_PULSE_LENGTH);
+	alecto_ws1700->raw[73]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, temperature = 0, humidity = 0, battery = 1;
+	double itmp = 0, temp = 0;
+	int i = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+		logprintf(LOG_ERR, "alecto_ws1700: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	temperature = (int)round(temp*10);
+	if(json_find_number(code, "humidity", &itmp) == 0)
+		humidity = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+
+	if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "alecto_ws1700: invalid id range");
+		return EXIT_FAILURE;
+	} else if(temperature > 2047 || temperature < -2048) {
+		logprintf(LOG_ERR, "alecto_ws1700: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity > 100 || humidity < 0) {
+		logprintf(LOG_ERR, "alecto_ws1700: invalid humidity range");
+		return EXIT_FAILURE;
+	} else {
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 0, 3, 5);
+		decToBinRangeRev(binary, 4, 11, id);
+		binary[12] = (battery != 0);
+		decToBinRangeRev(binary, 16, 27, temperature);
+		decToBinRangeRev(binary, 28, 35, humidity);
+
+		createMessage(id, (double)temperature/10, humidity, (battery != 0));
+		for(i=0;i<36;i++) {
+			if(binary[i] == 1) {
+				createHigh(i*2, i*2+1);
+			} else {
+				createLow(i*2, i*2+1);
+			}
+		}
+		createFooter();
+		alecto_ws1700->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -199,6 +282,8 @@ void alectoWS1700Init(void) {
 	options_add(&alecto_ws1700->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	alecto_ws1700->parseCode=&parseCode;
+	alecto_ws1700->createCode=&createCode;
+	alecto_ws1700->printHelp=&printHelp;
 	alecto_ws1700->checkValues=&checkValues;
 	alecto_ws1700->validate=&validate;
 	alecto_ws1700->gc=&gc;
@@ -59,6 +59,13 @@ static int validate(void)
 	return -1;
 }
 
+static void createMessage(int id, double temperature)
+{
+	alecto_wsd17->message = json_mkobject();
+	json_append_member(alecto_wsd17->message, "id", json_mknumber(id, 0));
+	json_append_member(alecto_wsd17->message, "temperature", json_mknumber(temperature / 10, 1));
+}
+
 static void parseCode(void)
 {
 	int i = 0, x = 0, id = 0, binary[RAW_LENGTH / 2];
@@ -104,9 +111,7 @@ static void parseCode(void)
 		return;
 	}
 
-	alecto_wsd17->message = json_mkobject();
-	json_append_member(alecto_wsd17->message, "id", json_mknumber(id, 0));
-	json_append_member(alecto_wsd17->message, "temperature", json_mknumber(temperature / 10, 1));
+	createMessage(id, temperature);
 }
 
 static int checkValues(struct JsonNode *jvalues)
@@ -181,6 +186,91 @@ static void gc(void)
 	}
 }
 
+static void createLow(int s, int e)
+{
+	int i;
+
+	for (i = s; i <= e; i += 2)
+	{
+		alecto_wsd17->raw[i] = (AVG_PULSE_LENGTH);
+		alecto_wsd17->raw[i + 1] = (AVG_PULSE_LENGTH * PULSE_MULTIPLIER / 4);
+	}
+}
+
+static void createHigh(int s, int e)
+{
+	int i;
+
+	for (i = s; i <= e; i += 2)
+	{
+		alecto_wsd17->raw[i] = (AVG_PULSE_LENGTH);
+		alecto_wsd17->raw[i + 1] = (AVG_PULSE_LENGTH * PULSE_MULTIPLIER * 3 / 4);
+	}
+}
+
+static void createFooter(void)
+{
+	alecto_wsd17->raw[72] = (AVG_PULSE_LENGTH);
+	alecto_wsd17->raw[73] = (PULSE_DIV * AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code)
+{
+	int binary[RAW_LENGTH / 2];
+	int id = 0, temperature = 0;
+	double itmp = 0, temp = 0;
+	int i = 0;
+
+	if (json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0)
+	{
+		logprintf(LOG_ERR, "alecto_wsd17: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	temperature = (int)round(temp * 10);
+
+	if (id > 4095 || id < 0)
+	{
+		logprintf(LOG_ERR, "alecto_wsd17: invalid id range");
+		return EXIT_FAILURE;
+	}
+	else if (temperature > 100 || temperature < 0)
+	{
+		// parseCode() drops values above 10.0
+		logprintf(LOG_ERR, "alecto_wsd17: invalid temperature range");
+		return EXIT_FAILURE;
+	}
+	else
+	{
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 0, 11, id);
+		decToBinRangeRev(binary, 16, 27, temperature);
+
+		createMessage(id, temperature);
+		for (i = 0; i < 36; i++)
+		{
+			if (binary[i] == 1)
+			{
+				createHigh(i * 2, i * 2 + 1);
+			}
+			else
+			{
+				createLow(i * 2, i * 2 + 1);
+			}
+		}
+		createFooter();
+		alecto_wsd17->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void)
+{
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -206,6 +296,8 @@ alectoWSD17Init(void)
 	options_add(&alecto_wsd17->options, "0", "show-temperature", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	alecto_wsd17->parseCode = &parseCode;
+	alecto_wsd17->createCode = &createCode;
+	alecto_wsd17->printHelp = &printHelp;
 	alecto_wsd17->checkValues = &checkValues;
 	alecto_wsd17->validate = &validate;
 	alecto_wsd17->gc = &gc;
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/checksum.h"
 #include "../../core/gc.h"
 #include "alecto_wx500.h"
 //
@@ -66,9 +67,8 @@ static void parseCode(void) {
 	double humidity = 0.0, temperature = 0.0;
 	int winddir = 0, windavg = 0, windgust = 0;
 	int /*rain = 0, */battery = 0;
-	int n0 = 0, n1 = 0, n2 = 0, n3 = 0;
-	int n4 = 0, n5 = 0, n6 = 0, n7 = 0, n8 = 0;
-	int checksum = 1;
+	uint8_t n[9];
+	int sum = 0, checksum = 1;
 
 	if(alecto_wx500->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "alecto_wx500: parsecode - invalid parameter passed %d", alecto_wx500->rawlen);
@@ -83,15 +83,8 @@ static void parseCode(void) {
 		}
 	}
 
-	n8=binToDec(binary, 32, 35);
-	n7=binToDec(binary, 28, 31);
-	n6=binToDec(binary, 24, 27);
-	n5=binToDec(binary, 20, 23);
-	n4=binToDec(binary, 16, 19);
-	n3=binToDec(binary, 12, 15);
-	n2=binToDec(binary, 8, 11);
-	n1=binToDec(binary, 4, 7);
-	n0=binToDec(binary, 0, 3);
+	binToNibbles(binary, 0, 35, n);
+	sum = addNibbles(n, 8);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -103,34 +96,34 @@ static void parseCode(void) {
 		tmp = tmp->next;
 	}
 
-	if((n2 & 0x6) != 0x6) {
+	if((n[2] & 0x6) != 0x6) {
 		type = 0x1;
-		checksum = (0xf-n0-n1-n2-n3-n4-n5-n6-n7) & 0xf;
-		if(n8 != checksum) {
+		checksum = (0xf-sum) & 0xf;
+		if(n[8] != checksum) {
 			type=0x5;
 			return;
 		}
 	//Wind average * 0.2
-	} else if(n3 == 0x1) {
+	} else if(n[3] == 0x1) {
 		type = 0x2;
-		checksum = (0xf-n0-n1-n2-n3-n4-n5-n6-n7) & 0xf;
-		if(n8 != checksum){
+		checksum = (0xf-sum) & 0xf;
+		if(n[8] != checksum){
 			type=0x5;
 			return;
 		}
 	//Wind direction & gust
-	} else if((n3 & 0x7) == 0x7) {
+	} else if((n[3] & 0x7) == 0x7) {
 		type = 0x3;
-		checksum = (0xf-n0-n1-n2-n3-n4-n5-n6-n7) & 0xf;
-		if(n8 != checksum) {
+		checksum = (0xf-sum) & 0xf;
+		if(n[8] != checksum) {
 			type=0x5;
 			return;
 		}
 	//Rain
-	} else if(n3 == 0x3)	{
+	} else if(n[3] == 0x3)	{
 		type = 0x4;
-		checksum = (0x7+n0+n1+n2+n3+n4+n5+n6+n7) & 0xf;
-		if(n8 != checksum){
+		checksum = (0x7+sum) & 0xf;
+		if(n[8] != checksum){
 			type = 0x5;
 			return;
 		}
@@ -258,6 +251,135 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		alecto_wx500->raw[i]=(AVG_PULSE_LENGTH);
+		alecto_wx500->raw[i+1]=(ZERO_PULSE);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		alecto_wx500->raw[i]=(AVG_PULSE_LENGTH);
+		alecto_wx500->raw[i+1]=(ONE_PULSE);
+	}
+}
+
+static void createFooter(void) {
+	alecto_wx500->raw[72]=(AVG_PULSE_LENGTH);
+	alecto_wx500->raw[73]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, battery = 1, temperature = 0, humidity = 0;
+	int winddir = 0, windavg = 0, windgust = 0;
+	double itmp = 0, temp = 0;
+	uint8_t n[9];
+	int type = 0, i = 0;
+
+	if(json_find_number(code, "id", &itmp) == 0)
+		id = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+	if(json_find_number(code, "temperature", &temp) == 0) {
+		type = 0x1;
+		temperature = (int)round(temp*10);
+		if(json_find_number(code, "humidity", &itmp) == 0)
+			humidity = (int)round(itmp);
+	} else if(json_find_number(code, "windavg", &itmp) == 0) {
+		type = 0x2;
+		windavg = (int)round(itmp*5);
+	} else if(json_find_number(code, "winddir", &itmp) == 0) {
+		type = 0x3;
+		winddir = (int)round(itmp);
+		if(json_find_number(code, "windgust", &itmp) == 0)
+			windgust = (int)round(itmp*5);
+	}
+
+	if(json_find_member(code, "id") == NULL || type == 0) {
+		logprintf(LOG_ERR, "alecto_wx500: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "alecto_wx500: invalid id range");
+		return EXIT_FAILURE;
+	} else if(temperature > 2047 || temperature < -999) {
+		logprintf(LOG_ERR, "alecto_wx500: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity > 99 || humidity < 0) {
+		logprintf(LOG_ERR, "alecto_wx500: invalid humidity range");
+		return EXIT_FAILURE;
+	} else if(winddir > 359 || winddir < 0) {
+		logprintf(LOG_ERR, "alecto_wx500: invalid winddir range");
+		return EXIT_FAILURE;
+	} else if(windavg > 255 || windavg < 0 || windgust > 255 || windgust < 0) {
+		logprintf(LOG_ERR, "alecto_wx500: invalid wind speed range");
+		return EXIT_FAILURE;
+	}
+
+	memset(binary, 0, sizeof(binary));
+	decToBinRange(binary, 0, 7, id);
+	binary[8] = !battery;
+
+	alecto_wx500->message = json_mkobject();
+	json_append_member(alecto_wx500->message, "id", json_mknumber(id, 0));
+	switch(type) {
+		case 1:
+			decToBinRange(binary, 12, 23, temperature);
+			decToBinRange(binary, 24, 27, humidity % 10);
+			decToBinRange(binary, 28, 31, humidity / 10);
+			json_append_member(alecto_wx500->message, "temperature", json_mknumber((double)temperature/10, 1));
+			json_append_member(alecto_wx500->message, "humidity", json_mknumber(humidity, 1));
+		break;
+		case 2:
+			/* wind average is marked by 0x6 in the third and 0x1 in the fourth nibble */
+			decToBinRange(binary, 9, 10, 0x3);
+			decToBinRange(binary, 12, 15, 0x1);
+			decToBinRange(binary, 24, 31, windavg);
+			json_append_member(alecto_wx500->message, "windavg", json_mknumber((double)windavg/5, 1));
+		break;
+		case 3:
+			/* wind direction and gust by 0x7 in the fourth nibble */
+			decToBinRange(binary, 9, 10, 0x3);
+			decToBinRange(binary, 12, 14, 0x7);
+			decToBinRange(binary, 15, 23, winddir);
+			decToBinRange(binary, 24, 31, windgust);
+			json_append_member(alecto_wx500->message, "winddir", json_mknumber((double)winddir, 0));
+			json_append_member(alecto_wx500->message, "windgust", json_mknumber((double)windgust/5, 1));
+		break;
+	}
+	json_append_member(alecto_wx500->message, "battery", json_mknumber((battery != 0), 0));
+
+	binToNibbles(binary, 0, 31, n);
+	decToBinRange(binary, 32, 35, (0xf-addNibbles(n, 8)) & 0xf);
+
+	for(i=0;i<36;i++) {
+		if(binary[i] == 1) {
+			createHigh(i*2, i*2+1);
+		} else {
+			createLow(i*2, i*2+1);
+		}
+	}
+	createFooter();
+	alecto_wx500->rawlen = RAW_LENGTH;
+
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity with the temperature\n");
+	printf("\t -w --windavg=windavg\t\tsend this average wind speed\n");
+	printf("\t -d --winddir=winddir\t\tsend this wind direction\n");
+	printf("\t -g --windgust=windgust\t\tsend this wind gust with the direction\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -300,6 +422,8 @@ void alectoWX500Init(void) {
 	//options_add(&alecto_wx500->options, "0", "show-rain", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)0, "^[10]{1}$");
 
 	alecto_wx500->parseCode=&parseCode;
+	alecto_wx500->createCode=&createCode;
+	alecto_wx500->printHelp=&printHelp;
 	alecto_wx500->checkValues=&checkValues;
 	alecto_wx500->validate=&validate;
 	alecto_wx500->gc=&gc;
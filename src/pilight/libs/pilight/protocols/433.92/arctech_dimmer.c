@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "arctech_dimmer.h"
 
@@ -39,6 +40,22 @@
 #define MAX_RAW_LENGTH		148
 #define MIN_RAW_LENGTH		132
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 25, 1 },	/* id */
+	{ 26, 26, 0 },	/* all */
+	{ 27, 27, 0 },	/* state */
+	{ 28, 31, 1 },	/* unit */
+	{ 32, 35, 1 },	/* dimlevel */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(arctech_dimmer->rawlen == MAX_RAW_LENGTH || arctech_dimmer->rawlen == MIN_RAW_LENGTH) {
 		if(arctech_dimmer->raw[arctech_dimmer->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -82,29 +99,17 @@ static void createMessage(int id, int unit, int state, int all, int dimlevel, in
 }
 
 static void parseCode(void) {
-	int binary[MAX_RAW_LENGTH/4], x = 0, i = 0;
+	int binary[MAX_RAW_LENGTH/4], values[5];
 
 	if(arctech_dimmer->rawlen>MAX_RAW_LENGTH) {
 		logprintf(LOG_ERR, "arctech_dimmer: parsecode - invalid parameter passed %d", arctech_dimmer->rawlen);
 		return;
 	}
 
-	for(x=0;x<arctech_dimmer->rawlen;x+=4) {
-		if(arctech_dimmer->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeParse(&pulsecode, arctech_dimmer->raw, arctech_dimmer->rawlen, binary, values);
 
-	int dimlevel = -1;
-	if(arctech_dimmer->rawlen == MAX_RAW_LENGTH) {
-		dimlevel = binToDecRev(binary, 32, 35);
-	}
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+	int id = values[0], all = values[1], state = values[2], unit = values[3];
+	int dimlevel = values[4];
 
 	createMessage(id, unit, state, all, dimlevel, 0);
 }
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "../../core/pilight.h"
 #include "../../core/common.h"
@@ -26,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "arctech_motion.h"
 
@@ -35,6 +37,21 @@
 #define AVG_PULSE_LENGTH	279
 #define RAW_LENGTH				132
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 25, 1 },	/* id */
+	{ 26, 26, 0 },	/* all */
+	{ 27, 27, 0 },	/* state */
+	{ 28, 31, 1 },	/* unit */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(arctech_motion->rawlen == RAW_LENGTH) {
 		if(arctech_motion->raw[arctech_motion->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -64,27 +81,146 @@ static void createMessage(int id, int unit, int state, int all) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	int binary[RAW_LENGTH/4], values[4];
 
 	if(arctech_motion->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "arctech_motion: parsecode - invalid parameter passed %d", arctech_motion->rawlen);
 		return;
 	}
 
-	for(x=0;x<arctech_motion->rawlen;x+=4) {
-		if(arctech_motion->raw[x+3] > AVG_PULSE_LENGTH*PULSE_MULTIPLIER) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
+	pulsecodeParse(&pulsecode, arctech_motion->raw, arctech_motion->rawlen, binary, values);
+
+	int id = values[0], all = values[1], state = values[2], unit = values[3];
+
+	createMessage(id, unit, state, all);
+}
+
+/* long pulses exceed the AVG_PULSE_LENGTH*PULSE_MULTIPLIER decoding threshold */
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=4) {
+		arctech_motion->raw[i]=(AVG_PULSE_LENGTH);
+		arctech_motion->raw[i+1]=(AVG_PULSE_LENGTH);
+		arctech_motion->raw[i+2]=(AVG_PULSE_LENGTH);
+		arctech_motion->raw[i+3]=(AVG_PULSE_LENGTH*(PULSE_MULTIPLIER+1));
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=4) {
+		arctech_motion->raw[i]=(AVG_PULSE_LENGTH);
+		arctech_motion->raw[i+1]=(AVG_PULSE_LENGTH*(PULSE_MULTIPLIER+1));
+		arctech_motion->raw[i+2]=(AVG_PULSE_LENGTH);
+		arctech_motion->raw[i+3]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void clearCode(void) {
+	createLow(2, 131);
+}
+
+static void createStart(void) {
+	arctech_motion->raw[0]=(AVG_PULSE_LENGTH);
+	arctech_motion->raw[1]=(9*AVG_PULSE_LENGTH);
+}
+
+static void createId(int id) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBin(id, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=((length-i)+1)*4;
+			createHigh(106-x, 106-(x-3));
 		}
 	}
+}
 
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+static void createAll(int all) {
+	if(all == 1) {
+		createHigh(106, 109);
+	}
+}
 
-	createMessage(id, unit, state, all);
+static void createState(int state) {
+	if(state == 1) {
+		createHigh(110, 113);
+	}
+}
+
+static void createUnit(int unit) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBin(unit, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=((length-i)+1)*4;
+			createHigh(130-x, 130-(x-3));
+		}
+	}
+}
+
+static void createFooter(void) {
+	arctech_motion->raw[131]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int id = -1;
+	int unit = -1;
+	int state = -1;
+	int all = 0;
+	double itmp = -1;
+
+	if(json_find_number(code, "id", &itmp) == 0)
+		id = (int)round(itmp);
+	if(json_find_number(code, "unit", &itmp) == 0)
+		unit = (int)round(itmp);
+	if(json_find_number(code, "all", &itmp)	== 0)
+		all = (int)round(itmp);
+	if(json_find_number(code, "off", &itmp) == 0)
+		state=0;
+	else if(json_find_number(code, "on", &itmp) == 0)
+		state=1;
+
+	if(id == -1 || (unit == -1 && all == 0) || state == -1) {
+		logprintf(LOG_ERR, "arctech_motion: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(id > 67108863 || id < 1) {
+		logprintf(LOG_ERR, "arctech_motion: invalid id range");
+		return EXIT_FAILURE;
+	} else if((unit > 15 || unit < 0) && all == 0) {
+		logprintf(LOG_ERR, "arctech_motion: invalid unit range");
+		return EXIT_FAILURE;
+	} else {
+		if(unit == -1 && all == 1) {
+			unit = 0;
+		}
+		createMessage(id, unit, state, all);
+		createStart();
+		clearCode();
+		createId(id);
+		createAll(all);
+		createState(state);
+		createUnit(unit);
+		createFooter();
+		arctech_motion->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -t --on\t\t\tsend an on signal\n");
+	printf("\t -f --off\t\t\tsend an off signal\n");
+	printf("\t -u --unit=unit\t\t\tcontrol a device with this unit code\n");
+	printf("\t -i --id=id\t\t\tcontrol a device with this id\n");
+	printf("\t -a --all\t\t\tsend command to all devices with this id\n");
 }
 
 #if !defined(MODULE) && !defined(_WIN32)
@@ -108,6 +244,8 @@ void arctechMotionInit(void) {
 	options_add(&arctech_motion->options, "f", "off", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	arctech_motion->parseCode=&parseCode;
+	arctech_motion->createCode=&createCode;
+	arctech_motion->printHelp=&printHelp;
 	arctech_motion->validate=&validate;
 }
 
@@ -55,6 +55,14 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id, double temperature, int battery, int channel) {
+	auriol->message = json_mkobject();
+	json_append_member(auriol->message, "id", json_mknumber(id, 0));
+	json_append_member(auriol->message, "temperature", json_mknumber(temperature, 1));
+	json_append_member(auriol->message, "battery", json_mknumber(battery, 0));
+	json_append_member(auriol->message, "channel", json_mknumber(channel, 0));
+}
+
 static void parseCode(void) {
 	int i = 0, x = 0, binary[RAW_LENGTH/2];
 	int channel = 0, id = 0, battery = 0;
@@ -90,11 +98,7 @@ static void parseCode(void) {
 	temperature += temp_offset;
 
 	if(channel != 4) {
-		auriol->message = json_mkobject();
-		json_append_member(auriol->message, "id", json_mknumber(id, 0));
-		json_append_member(auriol->message, "temperature", json_mknumber(temperature, 1));
-		json_append_member(auriol->message, "battery", json_mknumber(battery, 0));
-		json_append_member(auriol->message, "channel", json_mknumber(channel, 0));
+		createMessage(id, temperature, battery, channel);
 	}
 }
 
@@ -158,6 +162,84 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		auriol->raw[i]=(AVG_PULSE_LENGTH);
+		auriol->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		auriol->raw[i]=(AVG_PULSE_LENGTH);
+		auriol->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3/2);
+	}
+}
+
+static void createFooter(void) {
+	auriol->raw[64]=(AVG_PULSE_LENGTH);
+	auriol->raw[65]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, temperature = 0, channel = 1, battery = 1;
+	double itmp = 0, temp = 0;
+	int i = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+		logprintf(LOG_ERR, "auriol: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	temperature = (int)round(temp*10);
+	if(json_find_number(code, "channel", &itmp) == 0)
+		channel = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+
+	if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "auriol: invalid id range");
+		return EXIT_FAILURE;
+	} else if(channel > 3 || channel < 1) {
+		logprintf(LOG_ERR, "auriol: invalid channel range");
+		return EXIT_FAILURE;
+	} else if(temperature > 2047 || temperature < -2048) {
+		logprintf(LOG_ERR, "auriol: invalid temperature range");
+		return EXIT_FAILURE;
+	} else {
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 0, 7, id);
+		binary[8] = (battery != 0);
+		decToBinRangeRev(binary, 10, 11, channel-1);
+		decToBinRangeRev(binary, 12, 23, temperature);
+
+		createMessage(id, (double)temperature/10, (battery != 0), channel);
+		for(i=0;i<32;i++) {
+			if(binary[i] == 1) {
+				createHigh(i*2, i*2+1);
+			} else {
+				createLow(i*2, i*2+1);
+			}
+		}
+		createFooter();
+		auriol->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -c --channel=channel\t\tsend on this channel\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -185,6 +267,8 @@ void auriolInit(void) {
 	options_add(&auriol->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	auriol->parseCode=&parseCode;
+	auriol->createCode=&createCode;
+	auriol->printHelp=&printHelp;
 	auriol->checkValues=&checkValues;
 	auriol->validate=&validate;
 	auriol->gc=&gc;
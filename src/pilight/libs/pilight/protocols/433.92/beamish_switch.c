@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "beamish_switch.h"
 
@@ -37,7 +38,12 @@
 #define AVG_PULSE_LENGTH	323
 #define RAW_LENGTH				50
 
-static int map[7] = {0, 192, 48, 12, 3, 15, 195};
+static const uint8_t map[7] PROGMEM = {0, 192, 48, 12, 3, 15, 195};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2
+};
 
 static int validate(void) {
 	if(beamish_switch->rawlen == RAW_LENGTH) {
@@ -67,7 +73,7 @@ static void createMessage(int id, int unit, int state, int all) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, y = 0, binary[RAW_LENGTH/2];
+	int y = 0, binary[RAW_LENGTH/2];
 	int id = -1, state = -1, unit = -1, all = 0, code = 0;
 
 	if(beamish_switch->rawlen>RAW_LENGTH) {
@@ -75,19 +81,13 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<beamish_switch->rawlen;x+=2) {
-		if(beamish_switch->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeBits(&pulsecode, beamish_switch->raw, beamish_switch->rawlen, binary);
 
 	id = binToDecRev(binary, 0, 15);
 	code = binToDecRev(binary, 16, 23);
 
 	for(y=0;y<7;y++) {
-		if(map[y] == code) {
+		if(pgm_read_byte(&map[y]) == code) {
 			unit = y;
 			break;
 		}
@@ -196,7 +196,7 @@ static int createCode(struct JsonNode *code) {
 		createMessage(id, unit, state, all);
 		clearCode();
 		createId(id);
-		unit = map[unit];
+		unit = pgm_read_byte(&map[unit]);
 		createUnit(unit);
 		createFooter();
 		beamish_switch->rawlen = RAW_LENGTH;
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "cleverwatts.h"
 
@@ -36,6 +37,22 @@
 #define AVG_PULSE_LENGTH	269
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 19, 1 },	/* id */
+	{ 20, 20, 0 },	/* state */
+	{ 21, 22, 1 },	/* unit */
+	{ 23, 23, 0 },	/* all */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.header = 1,
+	.footer = 1,
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(cleverwatts->rawlen == RAW_LENGTH) {
 		if(cleverwatts->raw[cleverwatts->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -62,7 +79,7 @@ static void createMessage(int id, int unit, int state, int all) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	int binary[RAW_LENGTH/2], values[4];
 	int id = 0, state = 0, unit = 0, all = 0;
 
 	if(cleverwatts->rawlen>RAW_LENGTH) {
@@ -70,18 +87,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<cleverwatts->rawlen-1;x+=2) {
-		if(cleverwatts->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeParse(&pulsecode, cleverwatts->raw, cleverwatts->rawlen, binary, values);
 
-	id = binToDecRev(binary, 0, 19);
-	state = binary[20];
-	unit = binToDecRev(binary, 21, 22);
-	all = binary[23];
+	id = values[0];
+	state = values[1];
+	unit = values[2];
+	all = values[3];
 
 	createMessage(id, unit, state, all);
 }
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "../../core/pilight.h"
 #include "../../core/common.h"
@@ -26,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "conrad_rsl_contact.h"
 
@@ -35,6 +37,12 @@
 #define AVG_PULSE_LENGTH	190
 #define RAW_LENGTH				66
 
+static const struct pulsecode_t pulsecode = {
+	.width = 2,
+	.pulse = 1,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2
+};
+
 static int validate(void) {
 	if(conrad_rsl_contact->rawlen == RAW_LENGTH) {
 		if(conrad_rsl_contact->raw[conrad_rsl_contact->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -57,7 +65,7 @@ static void createMessage(int id, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/2];
+	int binary[RAW_LENGTH/2];
 
 	if(conrad_rsl_contact->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "conrad_rsl_contact: parsecode - invalid parameter passed %d", conrad_rsl_contact->rawlen);
@@ -65,13 +73,7 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0; x<conrad_rsl_contact->rawlen; x+=2) {
-		if(conrad_rsl_contact->raw[x+1] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/2]=1;
-		} else {
-			binary[x/2]=0;
-		}
-	}
+	pulsecodeBits(&pulsecode, conrad_rsl_contact->raw, conrad_rsl_contact->rawlen, binary);
 
 	int id = binToDecRev(binary, 6, 31);
 	int check = binToDecRev(binary, 0, 3);
@@ -83,6 +85,91 @@ static void parseCode(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		conrad_rsl_contact->raw[i]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+		conrad_rsl_contact->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		conrad_rsl_contact->raw[i]=(AVG_PULSE_LENGTH);
+		conrad_rsl_contact->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0, 63);
+	/* check nibble 0101 */
+	createHigh(2, 3);
+	createHigh(6, 7);
+}
+
+static void createState(int state) {
+	if(state == 1) {
+		createHigh(8, 9);
+	}
+}
+
+static void createId(int id) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBin(id, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=(31-(length-i))*2;
+			createHigh(x, x+1);
+		}
+	}
+}
+
+static void createFooter(void) {
+	conrad_rsl_contact->raw[64]=(AVG_PULSE_LENGTH);
+	conrad_rsl_contact->raw[65]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int id = -1;
+	int state = -1;
+	double itmp = 0;
+
+	if(json_find_number(code, "id", &itmp) == 0)
+		id = (int)round(itmp);
+	if(json_find_number(code, "opened", &itmp) == 0)
+		state=1;
+	else if(json_find_number(code, "closed", &itmp) == 0)
+		state=0;
+
+	if(id == -1 || state == -1) {
+		logprintf(LOG_ERR, "conrad_rsl_contact: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(id > 67108863 || id < 0) {
+		logprintf(LOG_ERR, "conrad_rsl_contact: invalid id range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(id, state);
+		clearCode();
+		createState(state);
+		createId(id);
+		createFooter();
+		conrad_rsl_contact->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tcontrol a device with this id\n");
+	printf("\t -t --opened\t\t\tsend an opened signal\n");
+	printf("\t -f --closed\t\t\tsend a closed signal\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -103,6 +190,8 @@ void conradRSLContactInit(void) {
 	options_add(&conrad_rsl_contact->options, "f", "closed", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	conrad_rsl_contact->parseCode=&parseCode;
+	conrad_rsl_contact->createCode=&createCode;
+	conrad_rsl_contact->printHelp=&printHelp;
 	conrad_rsl_contact->validate=&validate;
 }
 
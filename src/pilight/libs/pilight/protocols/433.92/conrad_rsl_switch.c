@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "conrad_rsl_switch.h"
 
@@ -38,7 +39,21 @@
 #define AVG_PULSE_LENGTH	200
 #define RAW_LENGTH				66
 
-static int codes[5][4][2];
+/* codes[id][unit][state], 0 where unknown */
+static const uint8_t codes[5][4][2] PROGMEM = {
+	{ { 190, 182 }, { 129, 142 }, { 174, 166 }, { 158, 150 } },
+	{ { 181, 185 }, { 141, 133 }, { 165, 169 }, { 149, 153 } },
+	{ { 184, 176 }, { 132, 136 }, { 168, 160 }, { 152, 144 } },
+	{ { 178, 188 }, { 138, 130 }, { 162, 172 }, { 146, 156 } },
+	{ { 163, 147 }, { 0, 0 }, { 0, 0 }, { 0, 0 } }
+};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 2,
+	.pulse = 1,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.inverted = 1
+};
 
 static int validate(void) {
 	if(conrad_rsl_switch->rawlen == RAW_LENGTH) {
@@ -73,7 +88,7 @@ static void createMessage(int id, int unit, int state, int learn) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/2];
+	int binary[RAW_LENGTH/2];
 	int id = 0, unit = 0, state = 0;
 
 	if(conrad_rsl_switch->rawlen>RAW_LENGTH) {
@@ -82,23 +97,17 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0;x<conrad_rsl_switch->rawlen;x+=2) {
-		if(conrad_rsl_switch->raw[x+1] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/2]=0;
-		} else {
-			binary[x/2]=1;
-		}
-	}
+	pulsecodeBits(&pulsecode, conrad_rsl_switch->raw, conrad_rsl_switch->rawlen, binary);
 
 	int check = binToDecRev(binary, 0, 7);
 	int match = 0;
 	for(id=0;id<5;id++) {
 		for(unit=0;unit<4;unit++) {
-			if(codes[id][unit][0] == check) {
+			if(pgm_read_byte(&codes[id][unit][0]) == check) {
 				state = 0;
 				match = 1;
 			}
-			if(codes[id][unit][1] == check) {
+			if(pgm_read_byte(&codes[id][unit][1]) == check) {
 				state = 1;
 				match = 1;
 			}
@@ -158,7 +167,7 @@ static void createId(int id, int unit, int state) {
 	int length = 0;
 	int i=0, x=0;
 
-	int code = codes[id][unit][state];
+	int code = pgm_read_byte(&codes[id][unit][state]);
 
 	length = decToBin(code, binary);
 	for(i=0;i<=length;i++) {
@@ -235,46 +244,6 @@ __attribute__((weak))
 #endif
 void conradRSLSwitchInit(void) {
 
-	memset(codes, 0, 33);
-	codes[0][0][0] = 190;
-	codes[0][0][1] = 182;
-	codes[0][1][0] = 129;
-	codes[0][1][1] = 142;
-	codes[0][2][0] = 174;
-	codes[0][2][1] = 166;
-	codes[0][3][0] = 158;
-	codes[0][3][1] = 150;
-
-	codes[1][0][0] = 181;
-	codes[1][0][1] = 185;
-	codes[1][1][0] = 141;
-	codes[1][1][1] = 133;
-	codes[1][2][0] = 165;
-	codes[1][2][1] = 169;
-	codes[1][3][0] = 149;
-	codes[1][3][1] = 153;
-
-	codes[2][0][0] = 184;
-	codes[2][0][1] = 176;
-	codes[2][1][0] = 132;
-	codes[2][1][1] = 136;
-	codes[2][2][0] = 168;
-	codes[2][2][1] = 160;
-	codes[2][3][0] = 152;
-	codes[2][3][1] = 144;
-
-	codes[3][0][0] = 178;
-	codes[3][0][1] = 188;
-	codes[3][1][0] = 138;
-	codes[3][1][1] = 130;
-	codes[3][2][0] = 162;
-	codes[3][2][1] = 172;
-	codes[3][3][0] = 146;
-	codes[3][3][1] = 156;
-
-	codes[4][0][0] = 163;
-	codes[4][0][1] = 147;
-
 	protocol_register(&conrad_rsl_switch);
 	protocol_set_id(conrad_rsl_switch, "conrad_rsl_switch");
 	protocol_device_add(conrad_rsl_switch, "conrad_rsl_switch", "Conrad RSL Switches");
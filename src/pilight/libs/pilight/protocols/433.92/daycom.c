@@ -26,6 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "../protocol.h"
 #include "daycom.h"
@@ -36,6 +37,20 @@
 #define AVG_PULSE_LENGTH        284
 #define RAW_LENGTH              50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 5, 1 },	/* id */
+	{ 6, 19, 1 },	/* systemcode */
+	{ 20, 20, 0 },	/* state */
+	{ 21, 23, 1 },	/* unit */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*(PULSE_MULTIPLIER/2),
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(daycom->rawlen == RAW_LENGTH) {
 		if(daycom->raw[daycom->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -60,7 +75,7 @@ static void createMessage(int id, int systemcode, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	int binary[RAW_LENGTH/2], values[4];
 	int id = -1, state = -1, unit = -1, systemcode = -1;
 
 	if(daycom->rawlen>RAW_LENGTH) {
@@ -68,18 +83,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<daycom->rawlen;x+=2) {
-		if(daycom->raw[x] > AVG_PULSE_LENGTH*(PULSE_MULTIPLIER/2)) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeParse(&pulsecode, daycom->raw, daycom->rawlen, binary, values);
 
-	id = binToDecRev(binary, 0, 5);
-	systemcode = binToDecRev(binary, 6, 19);
-	unit = binToDecRev(binary, 21, 23 );
-	state = binary[20];
+	id = values[0];
+	systemcode = values[1];
+	state = values[2];
+	unit = values[3];
 	createMessage(id, systemcode, unit, state);
 }
 
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "elro_400_switch.h"
 
@@ -36,6 +37,22 @@
 #define AVG_PULSE_LENGTH	296
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 4, 1 },	/* systemcode */
+	{ 5, 9, 1 },	/* unitcode */
+	{ 11, 11, 0 },	/* state */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.inverted = 1,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(elro_400_switch->rawlen == RAW_LENGTH) {
 		if(elro_400_switch->raw[elro_400_switch->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -59,24 +76,16 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, i = 0, binary[RAW_LENGTH/4];
+	int binary[RAW_LENGTH/4], values[3];
 
 	if(elro_400_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "elro_400_switch: parsecode - invalid parameter passed %d", elro_400_switch->rawlen);
 		return;
 	}
 
-	for(x=0;x<elro_400_switch->rawlen-2;x+=4) {
-		if(elro_400_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 0;
-		} else {
-			binary[i++] = 1;
-		}
-	}
+	pulsecodeParse(&pulsecode, elro_400_switch->raw, elro_400_switch->rawlen, binary, values);
 
-	int systemcode = binToDecRev(binary, 0, 4);
-	int unitcode = binToDecRev(binary, 5, 9);
-	int state = binary[11];
+	int systemcode = values[0], unitcode = values[1], state = values[2];
 	createMessage(systemcode, unitcode, state);
 }
 
@@ -37,21 +37,22 @@
 
 // About 2/3 of the jitter appears to make the pulses longer instead of shorter
 // The same jitter appears on every pulse type (as may be expected)
+// Integer limits, rounded inwards, to avoid floating point in the decoder
 
 // Short pulse timing
-#define MIN_SHORT_PULSE_LENGTH	(AVG_SHORT_PULSE_LENGTH - 0.333 * PEAK_TO_PEAK_JITTER)
+#define MIN_SHORT_PULSE_LENGTH	(AVG_SHORT_PULSE_LENGTH - (333 * PEAK_TO_PEAK_JITTER) / 1000)
 #define AVG_SHORT_PULSE_LENGTH	280
-#define MAX_SHORT_PULSE_LENGTH	(AVG_SHORT_PULSE_LENGTH + 0.667 * PEAK_TO_PEAK_JITTER)
+#define MAX_SHORT_PULSE_LENGTH	(AVG_SHORT_PULSE_LENGTH + (667 * PEAK_TO_PEAK_JITTER) / 1000)
 
 // Medium pulse timing
-#define MIN_MEDIUM_PULSE_LENGTH	(AVG_MEDIUM_PULSE_LENGTH - 0.333 * PEAK_TO_PEAK_JITTER)
+#define MIN_MEDIUM_PULSE_LENGTH	(AVG_MEDIUM_PULSE_LENGTH - (333 * PEAK_TO_PEAK_JITTER) / 1000)
 #define AVG_MEDIUM_PULSE_LENGTH	868
-#define MAX_MEDIUM_PULSE_LENGTH	(AVG_MEDIUM_PULSE_LENGTH + 0.667 * PEAK_TO_PEAK_JITTER)
+#define MAX_MEDIUM_PULSE_LENGTH	(AVG_MEDIUM_PULSE_LENGTH + (667 * PEAK_TO_PEAK_JITTER) / 1000)
 
 // Long pulse timing
-#define MIN_LONG_PULSE_LENGTH	(AVG_LONG_PULSE_LENGTH - 0.333 * PEAK_TO_PEAK_JITTER)
+#define MIN_LONG_PULSE_LENGTH	(AVG_LONG_PULSE_LENGTH - (333 * PEAK_TO_PEAK_JITTER) / 1000)
 #define AVG_LONG_PULSE_LENGTH	9660
-#define MAX_LONG_PULSE_LENGTH	(AVG_LONG_PULSE_LENGTH + 0.667 * PEAK_TO_PEAK_JITTER)
+#define MAX_LONG_PULSE_LENGTH	(AVG_LONG_PULSE_LENGTH + (667 * PEAK_TO_PEAK_JITTER) / 1000)
 
 #define RAW_LENGTH		50
 // Two pulses per bit, last two pulses are footer
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "ev1527.h"
 
@@ -36,6 +37,20 @@
 #define AVG_PULSE_LENGTH	256
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 19, 0 },	/* unitcode */
+	{ 20, 20, 0 },	/* state */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 2,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(ev1527->rawlen == RAW_LENGTH) {
 		if(ev1527->raw[ev1527->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -58,24 +73,100 @@ static void createMessage(int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	int binary[RAW_LENGTH/2], values[2];
 
 	if(ev1527->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "ev1527: parsecode - invalid parameter passed %d", ev1527->rawlen);
 		return;
 	}
 
-	for(x=0;x<ev1527->rawlen-2;x+=2) {
-		if(ev1527->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
+	pulsecodeParse(&pulsecode, ev1527->raw, ev1527->rawlen, binary, values);
+
+	int unitcode = values[0], state = values[1];
+	createMessage(unitcode, state);
+}
+
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		ev1527->raw[i]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+		ev1527->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		ev1527->raw[i]=(AVG_PULSE_LENGTH);
+		ev1527->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0, 47);
+}
+
+/* bit n is decoded from the second pulse of the (n+1)th symbol */
+static void createUnitCode(int unitcode) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBinRev(unitcode, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=(i+1)*2;
+			createHigh(x, x+1);
 		}
 	}
+}
 
-	int unitcode = binToDec(binary, 0, 19);
-	int state = binary[20];
-	createMessage(unitcode, state);
+static void createState(int state) {
+	if(state == 1) {
+		createHigh(42, 43);
+	}
+}
+
+static void createFooter(void) {
+	ev1527->raw[48]=(AVG_PULSE_LENGTH);
+	ev1527->raw[49]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int unitcode = -1;
+	int state = -1;
+	double itmp = 0;
+
+	if(json_find_number(code, "unitcode", &itmp) == 0)
+		unitcode = (int)round(itmp);
+	if(json_find_number(code, "closed", &itmp) == 0)
+		state=1;
+	else if(json_find_number(code, "opened", &itmp) == 0)
+		state=0;
+
+	if(unitcode == -1 || state == -1) {
+		logprintf(LOG_ERR, "ev1527: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(unitcode > 1048575 || unitcode < 0) {
+		logprintf(LOG_ERR, "ev1527: invalid unitcode range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(unitcode, state);
+		clearCode();
+		createUnitCode(unitcode);
+		createState(state);
+		createFooter();
+		ev1527->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -u --unitcode=unitcode\t\tcontrol a device with this unitcode\n");
+	printf("\t -t --opened\t\t\tsend an opened signal\n");
+	printf("\t -f --closed\t\t\tsend a closed signal\n");
 }
 
 #if !defined(MODULE) && !defined(_WIN32)
@@ -98,6 +189,8 @@ void ev1527Init(void) {
 	options_add(&ev1527->options, "f", "closed", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	ev1527->parseCode=&parseCode;
+	ev1527->createCode=&createCode;
+	ev1527->printHelp=&printHelp;
 	ev1527->validate=&validate;
 }
 
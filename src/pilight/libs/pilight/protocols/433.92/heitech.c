@@ -27,6 +27,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "../protocol.h"
 #include "heitech.h"
@@ -37,6 +38,22 @@
 #define AVG_PULSE_LENGTH	280
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 4, 0 },	/* systemcode */
+	{ 5, 9, 0 },	/* unitcode */
+	{ 10, 10, 0 },	/* check */
+	{ 11, 11, 0 },	/* state */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(heitech->rawlen == RAW_LENGTH) {
 		if(heitech->raw[heitech->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -61,25 +78,17 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/4];
+	int binary[RAW_LENGTH/4], values[4];
 
 	if(heitech->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "heitech: parsecode - invalid parameter passed %d", heitech->rawlen);
 		return;
 	}
 
-	for(x=0;x<heitech->rawlen-2;x+=4) {
-		if(heitech->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4]=1;
-		} else {
-			binary[x/4]=0;
-		}
-	}
+	pulsecodeParse(&pulsecode, heitech->raw, heitech->rawlen, binary, values);
 
-	int systemcode = binToDec(binary, 0, 4);
-	int unitcode = binToDec(binary, 5, 9);
-	int check = binary[10];
-	int state = binary[11];
+	int systemcode = values[0], unitcode = values[1];
+	int check = values[2], state = values[3];
 
 	if(check != state) {
 		createMessage(systemcode, unitcode, state);
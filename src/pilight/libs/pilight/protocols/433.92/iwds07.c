@@ -29,8 +29,8 @@
 
 static int validate(void) {
 	if(iwds07->rawlen == RAW_LENGTH) {
-		if(iwds07->raw[iwds07->rawlen-1] >= (FOOTER*0.9) &&
-			iwds07->raw[iwds07->rawlen-1] <= (FOOTER*1.1)) {
+		if(iwds07->raw[iwds07->rawlen-1] >= (FOOTER*9)/10 &&
+			iwds07->raw[iwds07->rawlen-1] <= (FOOTER*11)/10) {
 			return 0;
 		}
 	}
@@ -80,6 +80,100 @@ static void parseCode(void) {
 	createMessage(unit, alert, state, fault);
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		iwds07->raw[i]=(MIN_PULSE_LENGTH);
+		iwds07->raw[i+1]=(MAX_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		iwds07->raw[i]=(MAX_PULSE_LENGTH);
+		iwds07->raw[i+1]=(MIN_PULSE_LENGTH);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0, 47);
+}
+
+static void createUnit(int unit) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBinRev(unit, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=i*2;
+			createHigh(x, x+1);
+		}
+	}
+}
+
+static void createState(int alert, int state, int fault) {
+	if(alert == 1) {
+		createHigh(40, 41);
+	}
+	if(state == 1) {
+		createHigh(42, 43);
+	}
+	if(fault == 1) {
+		createHigh(46, 47);
+	}
+}
+
+static void createFooter(void) {
+	iwds07->raw[48]=(MIN_PULSE_LENGTH);
+	iwds07->raw[49]=(FOOTER);
+}
+
+static int createCode(struct JsonNode *code) {
+	int unit = -1;
+	int alert = -1, state = 0, fault = 0;
+	double itmp = 0;
+
+	if(json_find_number(code, "unit", &itmp) == 0)
+		unit = (int)round(itmp);
+	if(json_find_number(code, "opened", &itmp) == 0) {
+		alert = 1;
+	} else if(json_find_number(code, "closed", &itmp) == 0) {
+		alert = 1;
+		state = 1;
+	} else if(json_find_number(code, "tamper", &itmp) == 0) {
+		alert = 0;
+		fault = 1;
+	}
+
+	if(unit == -1 || alert == -1) {
+		logprintf(LOG_ERR, "iwds07: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(unit > 1048575 || unit < 0) {
+		logprintf(LOG_ERR, "iwds07: invalid unit range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(unit, alert, state, fault);
+		clearCode();
+		createUnit(unit);
+		createState(alert, state, fault);
+		createFooter();
+		iwds07->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -u --unit=unit\t\t\tcontrol a device with this unit\n");
+	printf("\t -t --opened\t\t\tsend an opened signal\n");
+	printf("\t -f --closed\t\t\tsend a closed signal\n");
+	printf("\t -a --tamper\t\t\tsend a tamper signal\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -101,6 +195,8 @@ void iwds07Init(void) {
 	options_add(&iwds07->options, "a", "tamper", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	iwds07->parseCode=&parseCode;
+	iwds07->createCode=&createCode;
+	iwds07->printHelp=&printHelp;
 	iwds07->validate=&validate;
 }
 
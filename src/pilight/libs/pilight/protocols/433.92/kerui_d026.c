@@ -17,6 +17,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "kerui_d026.h"
 
 
@@ -26,6 +27,22 @@
 #define AVG_PULSE_LENGTH	280
 #define RAW_LENGTH		50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 19, 0 },	/* unitcode */
+	{ 20, 20, 0 },	/* state */
+	{ 21, 21, 0 },	/* state2 */
+	{ 22, 22, 0 },	/* state3 */
+	{ 23, 23, 0 },	/* state4 */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(kerui_D026->rawlen == RAW_LENGTH) {
 		if(kerui_D026->raw[kerui_D026->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -55,22 +72,102 @@ static void createMessage(int unitcode, int state, int state2, int state3, int s
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	int binary[RAW_LENGTH/2], values[5];
+
+	pulsecodeParse(&pulsecode, kerui_D026->raw, kerui_D026->rawlen, binary, values);
+
+	createMessage(values[0], values[1], values[2], values[3], values[4]);
+}
+
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		kerui_D026->raw[i]=(AVG_PULSE_LENGTH);
+		kerui_D026->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		kerui_D026->raw[i]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+		kerui_D026->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0, 47);
+}
+
+static void createUnitCode(int unitcode) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
 
-	for(x=0;x<kerui_D026->rawlen-2;x+=2) {
-		if(kerui_D026->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
+	length = decToBinRev(unitcode, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=i*2;
+			createHigh(x, x+1);
 		}
 	}
+}
+
+/* the state is the one of the four state bits that is cleared */
+static void createState(int state) {
+	createHigh(40, 47);
+	if(state == 0) {
+		createLow(46, 47);
+	} else if(state == 1) {
+		createLow(40, 41);
+	} else {
+		createLow(42, 43);
+	}
+}
+
+static void createFooter(void) {
+	kerui_D026->raw[48]=(AVG_PULSE_LENGTH);
+	kerui_D026->raw[49]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int unitcode = -1;
+	int state = -1;
+	double itmp = 0;
+
+	if(json_find_number(code, "unitcode", &itmp) == 0)
+		unitcode = (int)round(itmp);
+	if(json_find_number(code, "opened", &itmp) == 0)
+		state=0;
+	else if(json_find_number(code, "closed", &itmp) == 0)
+		state=1;
+	else if(json_find_number(code, "tamper", &itmp) == 0)
+		state=2;
+
+	if(unitcode == -1 || state == -1) {
+		logprintf(LOG_ERR, "kerui_D026: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(unitcode > 1048575 || unitcode < 0) {
+		logprintf(LOG_ERR, "kerui_D026: invalid unitcode range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(unitcode, state != 1, state != 2, 1, state != 0);
+		clearCode();
+		createUnitCode(unitcode);
+		createState(state);
+		createFooter();
+		kerui_D026->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
 
-	int unitcode = binToDec(binary, 0, 19);
-	int state = binary[20];
-	int state2 = binary[21];
-	int state3 = binary[22];
-	int state4 = binary[23];
-	createMessage(unitcode, state, state2, state3, state4);
+static void printHelp(void) {
+	printf("\t -u --unitcode=unitcode\t\tcontrol a device with this unitcode\n");
+	printf("\t -t --opened\t\t\tsend an opened signal\n");
+	printf("\t -f --closed\t\t\tsend a closed signal\n");
+	printf("\t -a --tamper\t\t\tsend a tamper signal\n");
 }
 
 #if !defined(MODULE) && !defined(_WIN32)
@@ -94,6 +191,8 @@ void keruiD026Init(void) {
 	options_add(&kerui_D026->options, "a", "tamper", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	kerui_D026->parseCode=&parseCode;
+	kerui_D026->createCode=&createCode;
+	kerui_D026->printHelp=&printHelp;
 	kerui_D026->validate=&validate;
 }
 
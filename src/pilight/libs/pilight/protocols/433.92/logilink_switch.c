@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "logilink_switch.h"
 
@@ -36,6 +37,20 @@
 #define AVG_PULSE_LENGTH	284
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 19, 1 },	/* systemcode */
+	{ 20, 20, 0 },	/* state */
+	{ 21, 23, 1 },	/* unitcode */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 1,
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(logilink_switch->rawlen == RAW_LENGTH) {
 		if(logilink_switch->raw[logilink_switch->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -59,7 +74,7 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	int binary[RAW_LENGTH/2], values[3];
 	int systemcode = 0, state = 0, unitcode = 0;
 
 	if(logilink_switch->rawlen>RAW_LENGTH) {
@@ -67,16 +82,10 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<logilink_switch->rawlen-1;x+=2) {
-		if(logilink_switch->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
-	systemcode = binToDecRev(binary, 0, 19);
-	state = binary[20];
-	unitcode = binToDecRev(binary, 21, 23);
+	pulsecodeParse(&pulsecode, logilink_switch->raw, logilink_switch->rawlen, binary, values);
+	systemcode = values[0];
+	state = values[1];
+	unitcode = values[2];
 
 	createMessage(systemcode, unitcode, state);
 }
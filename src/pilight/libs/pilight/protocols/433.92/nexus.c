@@ -79,6 +79,16 @@ static int validate(void) {
     return -1;
 }
 
+static void createMessage(int id, int channel, int battery, double temperature, double humidity, double temperature_decimals) {
+    // build the JSON object
+    nexus->message = json_mkobject();
+    json_append_member(nexus->message, "id", json_mknumber(id, 0));
+    json_append_member(nexus->message, "channel", json_mknumber(channel, 0));
+    json_append_member(nexus->message, "battery", json_mknumber(battery, 0));
+    json_append_member(nexus->message, "temperature", json_mknumber(temperature, temperature_decimals));
+    json_append_member(nexus->message, "humidity", json_mknumber(humidity, 0));
+}
+
 static void parseCode(void) {
     int id = 0, battery = 0, channel = 0;
     double temperature = 0.0, humidity = 0.0;
@@ -131,13 +141,7 @@ static void parseCode(void) {
         tmp = tmp->next;
     }
 
-    // build the JSON object
-    nexus->message = json_mkobject();
-    json_append_member(nexus->message, "id", json_mknumber(id, 0));
-    json_append_member(nexus->message, "channel", json_mknumber(channel, 0));
-    json_append_member(nexus->message, "battery", json_mknumber(battery, 0));
-    json_append_member(nexus->message, "temperature", json_mknumber(temperature, temperature_decimals));
-    json_append_member(nexus->message, "humidity", json_mknumber(humidity, 0));
+    createMessage(id, channel, battery, temperature, humidity, temperature_decimals);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -204,6 +208,70 @@ static void gc(void) {
     }
 }
 
+static int createCode(struct JsonNode *code) {
+    int id = 0, channel = 0, battery = 1, temperature = 0, humidity = 0;
+    int binary[MAXBITS];
+    double itmp = 0, temp = 0;
+    int x = 0;
+
+    if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+        logprintf(LOG_ERR, "nexus: insufficient number of arguments");
+        return EXIT_FAILURE;
+    }
+
+    id = (int)round(itmp);
+    temperature = (int)round(temp * 10);
+    if(json_find_number(code, "channel", &itmp) == 0)
+        channel = (int)round(itmp);
+    if(json_find_number(code, "battery", &itmp) == 0)
+        battery = (int)round(itmp);
+    if(json_find_number(code, "humidity", &itmp) == 0)
+        humidity = (int)round(itmp);
+
+    if(id > 255 || id < 0) {
+        logprintf(LOG_ERR, "nexus: invalid id range");
+        return EXIT_FAILURE;
+    } else if(channel > 3 || channel < 0) {
+        logprintf(LOG_ERR, "nexus: invalid channel range");
+        return EXIT_FAILURE;
+    } else if(temperature > 2047 || temperature < -2048) {
+        logprintf(LOG_ERR, "nexus: invalid temperature range");
+        return EXIT_FAILURE;
+    } else if(humidity > 100 || humidity < 0) {
+        logprintf(LOG_ERR, "nexus: invalid humidity range");
+        return EXIT_FAILURE;
+    }
+
+    // encode data into bits, bit 10 is 0 and bits 25-28 are 1
+    memset(binary, 0, sizeof(binary));
+    decToBinRangeRev(binary, 0, 7, id);
+    binary[8] = (battery != 0);
+    decToBinRangeRev(binary, 10, 11, channel);
+    decToBinRangeRev(binary, 12, 23, temperature);
+    decToBinRangeRev(binary, 24, 27, 0xf);
+    decToBinRangeRev(binary, 28, 35, humidity);
+
+    // encode bits into pulses, followed by the sync
+    for(x = 0; x < MESSAGE_BITS; x++) {
+        nexus->raw[x * 2] = START_P;
+        nexus->raw[x * 2 + 1] = binary[x] ? ONE_P : ZERO_P;
+    }
+    nexus->raw[RAW_LENGTH - 2] = START_P;
+    nexus->raw[RAW_LENGTH - 1] = SYNC_P;
+    nexus->rawlen = RAW_LENGTH;
+
+    createMessage(id, channel, (battery != 0), (double)temperature / 10, humidity, 1);
+    return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+    printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+    printf("\t -c --channel=channel\t\tsend on this channel\n");
+    printf("\t -t --temperature=temperature\tsend this temperature\n");
+    printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+    printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -237,6 +305,8 @@ void nexusInit(void) {
     options_add(&nexus->options, "0", "show-channel", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
     nexus->parseCode = &parseCode;
+    nexus->createCode = &createCode;
+    nexus->printHelp = &printHelp;
     nexus->checkValues = &checkValues;
     nexus->validate = &validate;
     nexus->gc = &gc;
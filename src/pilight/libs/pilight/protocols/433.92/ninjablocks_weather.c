@@ -109,9 +109,8 @@ static void parseCode(void) {
 	int id = binToDecRev(binary, 8,9);
 	int dataSync = binToDecRev(binary, 10,12);
 	double humidity = binToDecRev(binary, 13,19);	// %
-	double temperature = binToDecRev(binary, 20,34);
 	// ((temp * (100 / 128)) - 5000) * 10 °C, 2 digits
-	temperature = ((int)((double)(temperature * 0.78125)) - 5000);
+	double temperature = ((binToDecRev(binary, 20,34) * 25) / 32) - 5000;
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -92,7 +92,7 @@ static int validate(void) {
 	return -1;
 }
 */
-int codetab[16][40] = {
+static const uint16_t codetab[16][40] PROGMEM = {
 	/* the next table contains the random codes (bits 4..19) of the 4 code sequences for
 	 * each off-on action for each switch 0..3 in each group-id 0..15.
 	 * For each group-id a separate array is created where de codes are stored in the next order:
@@ -169,7 +169,7 @@ int codetab[16][40] = {
 	  0x2636,0x6C81,0xE5B5,0xF1FA, 0x1067,0x3D02,0x9B1B,0 }
 };
 
-int unittab[2][5] = {
+static const uint8_t unittab[2][5] PROGMEM = {
 	/* This table defines the coding of the unit-id or switch-id. Two coding schemes are used
 	 * I call them first and second generation switches. They encode the unit-id in  a different way.
 	 */
@@ -179,7 +179,7 @@ int unittab[2][5] = {
 	{ 0xC, 0x5, 0xE, 0x7, 0x2 }	/* 2nd gen switch-codes */
 };
 
-int gentab[16] =
+static const uint8_t gentab[16] PROGMEM =
 	/* This table defines the switch generation for each group-id
 	 * A 0 at location x means group-id x belongs to first generation, and a 1 means second generation
 	 */
@@ -189,7 +189,7 @@ int gentab[16] =
 #define NRSUPERMASK 0x07
 #define NRSUPERCODES (NRSUPERMASK+1)	/* we will use 8 on and 8 off supercodes */
 /* make sure the number of Supercodes is always a power of 2, i.e. 2,4,8,16 ... */
-int supercodes[2*NRSUPERCODES] = {
+static const uint32_t supercodes[2*NRSUPERCODES] PROGMEM = {
 	/* since with supercodes group-id's are irrelevant, the codes consist of the first 20 bits of the code sequence */
 	/* OFF codes */
 	0x0F000,0x1F006,0x4F00E,0x5F016,0x8F01E,0x9F026,0xCF02E,0xDF02F,
@@ -278,9 +278,9 @@ static int fillBinCode(int id, int unit, int state, int codeseq) {
 
 	/* encode the right random code, depends on id, state and unit, state=0,1 */
 	rcodeindex= 8*unit + 4*state; /*calculate second index into codetab*/
-	if(codetab[id][rcodeindex + codeseq] == 0) {	/* no random code available? */
+	if(pgm_read_word(&codetab[id][rcodeindex + codeseq]) == 0) {	/* no random code available? */
 		/* then try first index */
-		if(codetab[id][rcodeindex] == 0) { /* and no first code available? */
+		if(pgm_read_word(&codetab[id][rcodeindex]) == 0) { /* and no first code available? */
 			logprintf(LOG_ERR, "quiggGT1000: no random code available for this switch action");
 			return EXIT_FAILURE;
 		} else {
@@ -289,19 +289,19 @@ static int fillBinCode(int id, int unit, int state, int codeseq) {
 		}
 	}
 	/* now we have an index for a valid random code, so put it in our codetab  starting at position 4 */
-	numtoBin(4, codetab[id][rcodeindex + codeseq], 16);
+	numtoBin(4, pgm_read_word(&codetab[id][rcodeindex + codeseq]), 16);
 
 	/* encode the unit part of the command */
 	/* key1..4 represents unit0..3, encoding depends on generation */
 	/* master key results in unit=4, encoding depends on generation */
-	genindex = gentab[id];	/* get 0 or 1 depending on generation of group-id */
-	numtoBin(20, unittab[genindex][unit], 4); /* get unit-id from tab and encode starting at pos 20 */
+	genindex = pgm_read_byte(&gentab[id]);	/* get 0 or 1 depending on generation of group-id */
+	numtoBin(20, pgm_read_byte(&unittab[genindex][unit]), 4); /* get unit-id from tab and encode starting at pos 20 */
 	return EXIT_SUCCESS;
 }
 
 static void fillSuperBinCode(int state, int codeseq) {
 	/* encode the right random supercode, depends on state=0,1 and codeseq*/
-	numtoBin(0, supercodes[NRSUPERCODES * state + codeseq], 20);
+	numtoBin(0, pgm_read_dword(&supercodes[NRSUPERCODES * state + codeseq]), 20);
 
 	/* encode the unit part of the command, is always 1000 or 8 */
 	numtoBin(20, 8, 4);
@@ -65,7 +65,7 @@
 	25       Footer (3000 7000)
 */
 
-char gt9000_unit_offon_map[16][2][4] = {{{8,2,11,7},{10,6,1,5}},   //unit 0 (untested)
+static const int8_t gt9000_unit_offon_map[16][2][4] PROGMEM = {{{8,2,11,7},{10,6,1,5}},   //unit 0 (untested)
          {{8,2,11,7},{10,6,1,5}},   //unit 1 (untested)
          {{8,2,11,7},{10,6,1,5}},   //unit 2 (working)
          {{8,2,11,7},{10,6,1,5}},   //unit 3
@@ -81,7 +81,7 @@ char gt9000_unit_offon_map[16][2][4] = {{{8,2,11,7},{10,6,1,5}},   //unit 0 (unt
          {{0,3,14,15},{4,9,12,13}}, //unit 13 (untested)
          {{0,3,14,15},{4,9,12,13}}, //unit 14
          {{0,3,14,15},{4,9,12,13}}};//unit 15 (untested)
-char gt9000_unit_offon_map2[16][2][4] = {{{1,2,9,10},{3,4,7,11}},  //unit 0
+static const int8_t gt9000_unit_offon_map2[16][2][4] PROGMEM = {{{1,2,9,10},{3,4,7,11}},  //unit 0
          {{1,2,9,10},{3,4,7,11}},   //unit 1 (untested)
          {{1,2,9,10},{3,4,7,11}},   //unit 2
          {{1,2,9,10},{3,4,7,11}},   //unit 3
@@ -98,9 +98,9 @@ char gt9000_unit_offon_map2[16][2][4] = {{{1,2,9,10},{3,4,7,11}},  //unit 0
          {{-1,-1,-1,-1},{-1,-1,-1,-1}},
          {{-1,-1,-1,-1},{-1,-1,-1,-1}}};
 
-int gt9000_hash[16] = { 0x0, 0x9, 0xF, 0x4, 0xA, 0xD, 0x5, 0xB,
+static const uint8_t gt9000_hash[16] PROGMEM = { 0x0, 0x9, 0xF, 0x4, 0xA, 0xD, 0x5, 0xB,
 			0x3, 0x2, 0x1, 0x7, 0xE, 0x6, 0xC, 0x8 };
-int gt9000_hash2[16] = { 0x0, 0x9, 0x5, 0xF, 0x3, 0x6, 0xC, 0x7,
+static const uint8_t gt9000_hash2[16] PROGMEM = { 0x0, 0x9, 0x5, 0xF, 0x3, 0x6, 0xC, 0x7,
 			 0xE, 0xD, 0x1, 0xB, 0x2, 0xA, 0x4, 0x8 };
 
 static int isSyscodeType1(int syscodetype) {
@@ -150,9 +150,9 @@ static int decodePayload(int payload, int index, int syscodetype) {
 	int ret = -1;
 
 	if(isSyscodeType1(syscodetype))
-		ret = payload^gt9000_hash[index];
+		ret = payload^pgm_read_byte(&gt9000_hash[index]);
 	else
-		ret = payload^gt9000_hash2[index];
+		ret = payload^pgm_read_byte(&gt9000_hash2[index]);
 
 	return ret;
 }
@@ -197,13 +197,13 @@ static void parseCode(void) {
 	//validate unit & statecode
 	if(isSyscodeType1(syscodetype)) {
 		for(i=0;i<4;i++) {
-			if(statecode == gt9000_unit_offon_map[unit][1][i]) {
+			if(statecode == (int8_t)pgm_read_byte(&gt9000_unit_offon_map[unit][1][i])) {
 				state = 1;
 			}
 		}
 	} else {
 		for(i=0;i<4;i++) {
-			if(statecode == gt9000_unit_offon_map2[unit][1][i]) {
+			if(statecode == (int8_t)pgm_read_byte(&gt9000_unit_offon_map2[unit][1][i])) {
 				state = 1;
 			}
 		}
@@ -281,13 +281,13 @@ static void initAllCodes(int systemcode, int allcodes[16]) {
 	for(i=0;i<16;i++) {
 		systemcode2enc = i;
 		if(isSyscodeType1(syscodetype)) {
-			systemcode3enc = gt9000_hash[systemcode2enc]^systemcode3dec;
-			systemcode4enc = gt9000_hash[systemcode3enc]^systemcode4dec;
-			systemcode5enc = gt9000_hash[systemcode4enc]^systemcode5dec;
+			systemcode3enc = pgm_read_byte(&gt9000_hash[systemcode2enc])^systemcode3dec;
+			systemcode4enc = pgm_read_byte(&gt9000_hash[systemcode3enc])^systemcode4dec;
+			systemcode5enc = pgm_read_byte(&gt9000_hash[systemcode4enc])^systemcode5dec;
 		} else { //if(systemcodetype == 13 || systemcodetype == 12)
-			systemcode3enc = gt9000_hash2[systemcode2enc]^systemcode3dec;
-			systemcode4enc = gt9000_hash2[systemcode3enc]^systemcode4dec;
-			systemcode5enc = gt9000_hash2[systemcode4enc]^systemcode5dec;
+			systemcode3enc = pgm_read_byte(&gt9000_hash2[systemcode2enc])^systemcode3dec;
+			systemcode4enc = pgm_read_byte(&gt9000_hash2[systemcode3enc])^systemcode4dec;
+			systemcode5enc = pgm_read_byte(&gt9000_hash2[systemcode4enc])^systemcode5dec;
 		}
 		allcodes[systemcode5enc] = (systemcode1enc<<16) + (systemcode2enc<<12) + (systemcode3enc<<8) + (systemcode4enc<<4) + systemcode5enc;
 	}
@@ -325,9 +325,9 @@ static int createCode(JsonNode *code) {
 		//we stick to code number 1 in the on/off array
 		syscodetype = (systemcode >> 16) & 0xF;
 		if(isSyscodeType1(syscodetype))
-			statecode = gt9000_unit_offon_map[unit][state][1];
+			statecode = (int8_t)pgm_read_byte(&gt9000_unit_offon_map[unit][state][1]);
 		else
-			statecode = gt9000_unit_offon_map2[unit][state][1];
+			statecode = (int8_t)pgm_read_byte(&gt9000_unit_offon_map2[unit][state][1]);
 
 		if(statecode==-1) {
 			logprintf(LOG_ERR, "quigg_gt9000: unit %d not supported, try 0-15.", unit);
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "rsl366.h"
 
@@ -36,6 +37,12 @@
 #define AVG_PULSE_LENGTH	380
 #define RAW_LENGTH		50
 
+static const struct pulsecode_t pulsecode = {
+	.header = 3,
+	.width = 4,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2
+};
+
 static int validate(void) {
 	if(rsl366->rawlen == RAW_LENGTH) {
 		if(rsl366->raw[rsl366->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -62,7 +69,7 @@ static void createMessage(int systemcode, int programcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, i = 0, binary[RAW_LENGTH/4];
+	int i = 0, binary[RAW_LENGTH/4];
 
 	if(rsl366->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "rsl366: parsecode - invalid parameter passed %d", rsl366->rawlen);
@@ -70,13 +77,7 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=3;x<rsl366->rawlen;x+=4) {
-		if(rsl366->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++]=1;
-		} else {
-			binary[i++]=0;
-		}
-	}
+	pulsecodeBits(&pulsecode, rsl366->raw, rsl366->rawlen, binary);
 
 	//Check if there is a valid systemcode
 	if((binary[0]+binary[1]+binary[2]+binary[3]) > 1)
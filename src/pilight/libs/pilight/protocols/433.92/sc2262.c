@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "sc2262.h"
 
@@ -36,6 +37,22 @@
 #define AVG_PULSE_LENGTH	432
 #define RAW_LENGTH				50
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 4, 0 },	/* systemcode */
+	{ 5, 9, 0 },	/* unitcode */
+	{ 10, 10, 0 },	/* check */
+	{ 11, 11, 0 },	/* state */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(sc2262->rawlen == RAW_LENGTH) {
 		if(sc2262->raw[sc2262->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -59,25 +76,127 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	int binary[RAW_LENGTH/4], values[4];
 
 	if(sc2262->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "sc2262: parsecode - invalid parameter passed %d", sc2262->rawlen);
 		return;
 	}
 
-	for(x=0;x<sc2262->rawlen-2;x+=4) {
-		if(sc2262->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
+	pulsecodeParse(&pulsecode, sc2262->raw, sc2262->rawlen, binary, values);
+
+	int systemcode = values[0], unitcode = values[1], state = values[3];
+	createMessage(systemcode, unitcode, state);
+}
+
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=4) {
+		sc2262->raw[i]=(AVG_PULSE_LENGTH);
+		sc2262->raw[i+1]=(PULSE_MULTIPLIER*AVG_PULSE_LENGTH);
+		sc2262->raw[i+2]=(PULSE_MULTIPLIER*AVG_PULSE_LENGTH);
+		sc2262->raw[i+3]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=4) {
+		sc2262->raw[i]=(AVG_PULSE_LENGTH);
+		sc2262->raw[i+1]=(PULSE_MULTIPLIER*AVG_PULSE_LENGTH);
+		sc2262->raw[i+2]=(AVG_PULSE_LENGTH);
+		sc2262->raw[i+3]=(PULSE_MULTIPLIER*AVG_PULSE_LENGTH);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0,47);
+}
+
+static void createSystemCode(int systemcode) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBinRev(systemcode, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=i*4;
+			createHigh(x, x+3);
 		}
 	}
+}
 
-	int systemcode = binToDec(binary, 0, 4);
-	int unitcode = binToDec(binary, 5, 9);
-	int state = binary[11];
-	createMessage(systemcode, unitcode, state);
+static void createUnitCode(int unitcode) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBinRev(unitcode, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=i*4;
+			createHigh(20+x, 20+x+3);
+		}
+	}
+}
+
+static void createState(int state) {
+	if(state == 1) {
+		createHigh(44, 47);
+	} else {
+		createHigh(40, 43);
+	}
+}
+
+static void createFooter(void) {
+	sc2262->raw[48]=(AVG_PULSE_LENGTH);
+	sc2262->raw[49]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int systemcode = -1;
+	int unitcode = -1;
+	int state = -1;
+	double itmp = 0;
+
+	if(json_find_number(code, "systemcode", &itmp) == 0)
+		systemcode = (int)round(itmp);
+	if(json_find_number(code, "unitcode", &itmp) == 0)
+		unitcode = (int)round(itmp);
+	if(json_find_number(code, "closed", &itmp) == 0)
+		state=1;
+	else if(json_find_number(code, "opened", &itmp) == 0)
+		state=0;
+
+	if(systemcode == -1 || unitcode == -1 || state == -1) {
+		logprintf(LOG_ERR, "sc2262: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(systemcode > 31 || systemcode < 0) {
+		logprintf(LOG_ERR, "sc2262: invalid systemcode range");
+		return EXIT_FAILURE;
+	} else if(unitcode > 31 || unitcode < 0) {
+		logprintf(LOG_ERR, "sc2262: invalid unitcode range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(systemcode, unitcode, state);
+		clearCode();
+		createSystemCode(systemcode);
+		createUnitCode(unitcode);
+		createState(state);
+		createFooter();
+		sc2262->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -s --systemcode=systemcode\tcontrol a device with this systemcode\n");
+	printf("\t -u --unitcode=unitcode\t\tcontrol a device with this unitcode\n");
+	printf("\t -t --opened\t\t\tsend an opened signal\n");
+	printf("\t -f --closed\t\t\tsend a closed signal\n");
 }
 
 #if !defined(MODULE) && !defined(_WIN32)
@@ -101,6 +220,8 @@ void sc2262Init(void) {
 	options_add(&sc2262->options, "f", "closed", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	sc2262->parseCode=&parseCode;
+	sc2262->createCode=&createCode;
+	sc2262->printHelp=&printHelp;
 	sc2262->validate=&validate;
 }
 
@@ -47,6 +47,12 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id) {
+	secudo_smoke->message = json_mkobject();
+	json_append_member(secudo_smoke->message, "id", json_mknumber(id, 0));
+	json_append_member(secudo_smoke->message, "state", json_mkstring("alarm"));
+}
+
 static void parseCode(void) {
 	int binary[RAW_LENGTH/2];
 	int id = 0;
@@ -70,9 +76,76 @@ static void parseCode(void) {
 	id = binToDec(binary, 0, 9);
 	id = (~id) & 1023;
 
-	secudo_smoke->message = json_mkobject();
-	json_append_member(secudo_smoke->message, "id", json_mknumber(id, 0));
-	json_append_member(secudo_smoke->message, "state", json_mkstring("alarm"));
+	createMessage(id);
+}
+
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		secudo_smoke->raw[i]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+		secudo_smoke->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		secudo_smoke->raw[i]=(AVG_PULSE_LENGTH);
+		secudo_smoke->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER);
+	}
+}
+
+static void clearCode(void) {
+	createLow(0, 23);
+}
+
+/* the id is sent inverted */
+static void createId(int id) {
+	int binary[255];
+	int length = 0;
+	int i=0, x=0;
+
+	length = decToBinRev((~id) & 1023, binary);
+	for(i=0;i<=length;i++) {
+		if(binary[i]==1) {
+			x=i*2;
+			createHigh(x, x+1);
+		}
+	}
+}
+
+static void createFooter(void) {
+	secudo_smoke->raw[24]=(AVG_PULSE_LENGTH);
+	secudo_smoke->raw[25]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int id = -1;
+	double itmp = 0;
+
+	if(json_find_number(code, "id", &itmp) == 0)
+		id = (int)round(itmp);
+
+	if(id == -1) {
+		logprintf(LOG_ERR, "secudo_smoke_sensor: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(id > 1023 || id < 0) {
+		logprintf(LOG_ERR, "secudo_smoke_sensor: invalid id range");
+		return EXIT_FAILURE;
+	} else {
+		createMessage(id);
+		clearCode();
+		createId(id);
+		createFooter();
+		secudo_smoke->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend an alarm of the device with this id\n");
 }
 
 #if !defined(MODULE) && !defined(_WIN32)
@@ -93,6 +166,8 @@ void secudoSmokeInit(void) {
 	options_add(&secudo_smoke->options, "t", "alarm", OPTION_NO_VALUE, DEVICES_STATE, JSON_STRING, NULL, NULL);
 
 	secudo_smoke->parseCode=&parseCode;
+	secudo_smoke->createCode=&createCode;
+	secudo_smoke->printHelp=&printHelp;
 	secudo_smoke->validate=&validate;
 }
 
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "selectremote.h"
 
@@ -36,6 +37,12 @@
 #define AVG_PULSE_LENGTH	396
 #define RAW_LENGTH				50
 
+static const struct pulsecode_t pulsecode = {
+	.footer = 2,
+	.width = 4,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2
+};
+
 static int validate(void) {
 	if(selectremote->rawlen == RAW_LENGTH) {
 		if(selectremote->raw[selectremote->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
@@ -58,20 +65,14 @@ static void createMessage(int id, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	int binary[RAW_LENGTH/4];
 
 	if(selectremote->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "selectremote: parsecode - invalid parameter passed %d", selectremote->rawlen);
 		return;
 	}
 
-	for(x=0;x<selectremote->rawlen-2;x+=4) {
-		if(selectremote->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeBits(&pulsecode, selectremote->raw, selectremote->rawlen, binary);
 
 	int id = 7-binToDec(binary, 1, 3);
 	int state = binary[8];
@@ -17,6 +17,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "smartwares_switch.h"
 
@@ -28,11 +29,26 @@
 #define AVG_PULSE_LENGTH	300
 #define RAW_LENGTH				132
 
+static const struct pulsecode_field_t fields[] = {
+	{ 0, 25, 1 },	/* id */
+	{ 26, 26, 0 },	/* all */
+	{ 27, 27, 0 },	/* state */
+	{ 28, 31, 1 },	/* unit */
+};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 4,
+	.pulse = 3,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2,
+	.fields = fields,
+	.nrfields = sizeof(fields)/sizeof(fields[0])
+};
+
 static int validate(void) {
 	if(smartwares_switch->rawlen == RAW_LENGTH) {
 		if(smartwares_switch->raw[smartwares_switch->rawlen-1] >= (MIN_PULSE_LENGTH*PULSE_DIV) &&
 		   smartwares_switch->raw[smartwares_switch->rawlen-1] <= (MAX_PULSE_LENGTH*PULSE_DIV) &&
-			 smartwares_switch->raw[1] >= AVG_PULSE_LENGTH*(PULSE_MULTIPLIER*1.5)) {
+			 smartwares_switch->raw[1] >= (AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3)/2) {
 			return 0;
 		}
 	}
@@ -65,25 +81,16 @@ static void createMessage(int id, int unit, int state, int all, int learn) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	int binary[RAW_LENGTH/4], values[4];
 
 	if(smartwares_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "smartwares_switch: parsecode - invalid parameter passed %d", smartwares_switch->rawlen);
 		return;
 	}
 
-	for(x=0;x<smartwares_switch->rawlen;x+=4) {
-		if(smartwares_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeParse(&pulsecode, smartwares_switch->raw, smartwares_switch->rawlen, binary, values);
 
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+	int id = values[0], all = values[1], state = values[2], unit = values[3];
 
 	createMessage(id, unit, state, all, 0);
 }
@@ -66,6 +66,15 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id, double temperature, double humidity, int battery, int button) {
+	tcm->message = json_mkobject();
+	json_append_member(tcm->message, "id", json_mknumber(id, 0));
+	json_append_member(tcm->message, "temperature", json_mknumber(temperature/10, 1));
+	json_append_member(tcm->message, "humidity", json_mknumber(humidity, 0));
+	json_append_member(tcm->message, "battery", json_mknumber(battery, 0));
+	json_append_member(tcm->message, "button", json_mknumber(button, 0));
+}
+
 static void parseCode(void) {
 	double humi_offset = 0.0, temp_offset = 0.0;
 	double temperature = 0.0, humidity = 0.0;
@@ -107,12 +116,7 @@ static void parseCode(void) {
 	temperature += temp_offset;
 	humidity += humi_offset;
 
-	tcm->message = json_mkobject();
-	json_append_member(tcm->message, "id", json_mknumber(id, 0));
-	json_append_member(tcm->message, "temperature", json_mknumber(temperature/10, 1));
-	json_append_member(tcm->message, "humidity", json_mknumber(humidity, 0));
-	json_append_member(tcm->message, "battery", json_mknumber(battery, 0));
-	json_append_member(tcm->message, "button", json_mknumber(button, 0));
+	createMessage(id, temperature, humidity, battery, button);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -177,6 +181,87 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tcm->raw[i]=(AVG_PULSE_LENGTH);
+		tcm->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tcm->raw[i]=(AVG_PULSE_LENGTH);
+		tcm->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3/2);
+	}
+}
+
+static void createFooter(void) {
+	tcm->raw[72]=(AVG_PULSE_LENGTH);
+	tcm->raw[73]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, temperature = 0, humidity = 0, battery = 1, button = 0;
+	double itmp = 0, temp = 0;
+	int i = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+		logprintf(LOG_ERR, "tcm: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	temperature = (int)round(temp*10);
+	if(json_find_number(code, "humidity", &itmp) == 0)
+		humidity = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+	if(json_find_number(code, "button", &itmp) == 0)
+		button = (int)round(itmp);
+
+	if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "tcm: invalid id range");
+		return EXIT_FAILURE;
+	} else if(temperature > 2047 || temperature < -2048) {
+		logprintf(LOG_ERR, "tcm: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity > 100 || humidity < 0) {
+		logprintf(LOG_ERR, "tcm: invalid humidity range");
+		return EXIT_FAILURE;
+	} else {
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 0, 7, id);
+		binary[8] = !battery;
+		binary[11] = (button != 0);
+		decToBinRangeRev(binary, 16, 23, humidity);
+		decToBinRangeRev(binary, 24, 35, temperature);
+
+		createMessage(id, temperature, humidity, (battery != 0), (button != 0));
+		for(i=0;i<36;i++) {
+			if(binary[i] == 1) {
+				createHigh(i*2, i*2+1);
+			} else {
+				createLow(i*2, i*2+1);
+			}
+		}
+		createFooter();
+		tcm->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -205,6 +290,8 @@ void tcmInit(void) {
 	options_add(&tcm->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	tcm->parseCode=&parseCode;
+	tcm->createCode=&createCode;
+	tcm->printHelp=&printHelp;
 	tcm->checkValues=&checkValues;
 	tcm->validate=&validate;
 	tcm->gc=&gc;
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/pulsecode.h"
 #include "../../core/gc.h"
 #include "techlico_switch.h"
 
@@ -37,7 +38,12 @@
 #define RAW_LENGTH				50
 #define NRMAP 						5
 
-static int map[NRMAP]={0, 3, 192, 15, 12};
+static const uint8_t map[NRMAP] PROGMEM = {0, 3, 192, 15, 12};
+
+static const struct pulsecode_t pulsecode = {
+	.width = 2,
+	.threshold = AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2
+};
 
 static int validate(void) {
 	if(techlico_switch->rawlen == RAW_LENGTH) {
@@ -63,7 +69,7 @@ static void createMessage(int id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, y = 0, binary[RAW_LENGTH/2];
+	int y = 0, binary[RAW_LENGTH/2];
 	int id = -1, state = -1, unit = -1, code = 0;
 
 	if(techlico_switch->rawlen>RAW_LENGTH) {
@@ -71,19 +77,13 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<techlico_switch->rawlen;x+=2) {
-		if(techlico_switch->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsecodeBits(&pulsecode, techlico_switch->raw, techlico_switch->rawlen, binary);
 
 	id = binToDecRev(binary, 0, 15);
 	code = binToDecRev(binary, 16, 23);
 
 	for(y=0;y<NRMAP;y++) {
-		if(map[y] == code) {
+		if(pgm_read_byte(&map[y]) == code) {
 			unit = y;
 			break;
 		}
@@ -178,7 +178,7 @@ static int createCode(struct JsonNode *code) {
 		createMessage(id, unit, state);
 		clearCode();
 		createId(id);
-		unit = map[unit];
+		unit = pgm_read_byte(&map[unit]);
 		createUnit(unit);
 		createFooter();
 		techlico_switch->rawlen = RAW_LENGTH;
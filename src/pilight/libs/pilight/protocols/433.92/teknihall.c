@@ -56,6 +56,14 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id, double temperature, double humidity, int battery) {
+	teknihall->message = json_mkobject();
+	json_append_member(teknihall->message, "id", json_mknumber(id, 1));
+	json_append_member(teknihall->message, "temperature", json_mknumber(temperature/10, 1));
+	json_append_member(teknihall->message, "humidity", json_mknumber(humidity, 1));
+	json_append_member(teknihall->message, "battery", json_mknumber(battery, 1));
+}
+
 static void parseCode(void) {
 	int i = 0, x = 0, binary[RAW_LENGTH/2];
 	int id = 0, battery = 0;
@@ -93,11 +101,7 @@ static void parseCode(void) {
 	temperature += temp_offset;
 	humidity += humi_offset;
 
-	teknihall->message = json_mkobject();
-	json_append_member(teknihall->message, "id", json_mknumber(id, 1));
-	json_append_member(teknihall->message, "temperature", json_mknumber(temperature/10, 1));
-	json_append_member(teknihall->message, "humidity", json_mknumber(humidity, 1));
-	json_append_member(teknihall->message, "battery", json_mknumber(battery, 1));
+	createMessage(id, temperature, humidity, battery);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -162,6 +166,84 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		teknihall->raw[i]=(AVG_PULSE_LENGTH);
+		teknihall->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER/4);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		teknihall->raw[i]=(AVG_PULSE_LENGTH);
+		teknihall->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3/4);
+	}
+}
+
+static void createFooter(void) {
+	teknihall->raw[74]=(AVG_PULSE_LENGTH);
+	teknihall->raw[75]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, temperature = 0, humidity = 0, battery = 1;
+	double itmp = 0, temp = 0;
+	int i = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+		logprintf(LOG_ERR, "teknihall: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	temperature = (int)round(temp*10);
+	if(json_find_number(code, "humidity", &itmp) == 0)
+		humidity = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+
+	if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "teknihall: invalid id range");
+		return EXIT_FAILURE;
+	} else if(temperature > 1023 || temperature < -1024) {
+		logprintf(LOG_ERR, "teknihall: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity > 100 || humidity < 0) {
+		logprintf(LOG_ERR, "teknihall: invalid humidity range");
+		return EXIT_FAILURE;
+	} else {
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 0, 7, id);
+		binary[8] = (battery != 0);
+		decToBinRangeRev(binary, 13, 23, temperature);
+		decToBinRangeRev(binary, 24, 30, humidity);
+
+		createMessage(id, temperature, humidity, (battery != 0));
+		for(i=0;i<37;i++) {
+			if(binary[i] == 1) {
+				createHigh(i*2, i*2+1);
+			} else {
+				createLow(i*2, i*2+1);
+			}
+		}
+		createFooter();
+		teknihall->rawlen = RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -192,6 +274,8 @@ void teknihallInit(void) {
 	options_add(&teknihall->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	teknihall->parseCode=&parseCode;
+	teknihall->createCode=&createCode;
+	teknihall->printHelp=&printHelp;
 	teknihall->checkValues=&checkValues;
 	teknihall->validate=&validate;
 	teknihall->gc=&gc;
@@ -27,6 +27,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/checksum.h"
 #include "../../core/gc.h"
 #include "tfa.h"
 
@@ -48,6 +49,7 @@ typedef struct settings_t {
 } settings_t;
 
 static struct settings_t *settings = NULL;
+static struct crc_t crc4;
 
 static int validate(void) {
 	if(tfa->rawlen == MIN_RAW_LENGTH || tfa->rawlen == MED_RAW_LENGTH || tfa->rawlen == MAX_RAW_LENGTH) {
@@ -59,6 +61,15 @@ static int validate(void) {
 	return -1;
 }
 
+static void createMessage(int id, double temperature, double humidity, int battery, int channel) {
+	tfa->message = json_mkobject();
+	json_append_member(tfa->message, "id", json_mknumber(id, 0));
+	json_append_member(tfa->message, "temperature", json_mknumber(temperature/100, 2));
+	json_append_member(tfa->message, "humidity", json_mknumber(humidity, 2));
+	json_append_member(tfa->message, "battery", json_mknumber(battery, 0));
+	json_append_member(tfa->message, "channel", json_mknumber(channel, 0));
+}
+
 static void parseCode(void) {
 	int binary[RAW_LENGTH/2];
 	int temp1 = 0, temp2 = 0, temp3 = 0;
@@ -91,13 +102,9 @@ static void parseCode(void) {
 	}
 
 	if(tfa->rawlen == MED_RAW_LENGTH || tfa->rawlen == MAX_RAW_LENGTH) {
-		for(i=0;i<34;i++) {
-			if(binary[i] != (crc&1)) {
-				crc = (crc>>1) ^ 12;
-			} else {
-				crc = (crc>>1);
-			}
-		}
+		uint8_t nibbles[9];
+		binToNibbles(binary, 0, 33, nibbles);
+		crc = crcNibbles(&crc4, nibbles, 34, 0);
 		crc ^= binToDec(binary, 34, 37);
 		if (crc != binToDec(binary, 38, 41)) {
 			return; // incorrect checksum
@@ -162,12 +169,7 @@ static void parseCode(void) {
 	temperature += temp_offset;
 	humidity += humi_offset;
 
-	tfa->message = json_mkobject();
-	json_append_member(tfa->message, "id", json_mknumber(id, 0));
-	json_append_member(tfa->message, "temperature", json_mknumber(temperature/100, 2));
-	json_append_member(tfa->message, "humidity", json_mknumber(humidity, 2));
-	json_append_member(tfa->message, "battery", json_mknumber(battery, 0));
-	json_append_member(tfa->message, "channel", json_mknumber(channel, 0));
+	createMessage(id, temperature, humidity, battery, channel);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -236,6 +238,103 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tfa->raw[i]=(AVG_PULSE_LENGTH);
+		tfa->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER/2);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tfa->raw[i]=(AVG_PULSE_LENGTH);
+		tfa->raw[i+1]=(AVG_PULSE_LENGTH*PULSE_MULTIPLIER*3/2);
+	}
+}
+
+static void createFooter(void) {
+	tfa->raw[MED_RAW_LENGTH-2]=(AVG_PULSE_LENGTH);
+	tfa->raw[MED_RAW_LENGTH-1]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+/* Creates the TFA variant of MED_RAW_LENGTH pulses */
+static int createCode(struct JsonNode *code) {
+	int binary[RAW_LENGTH/2];
+	int id = 0, channel = 1, humidity = 0, battery = 1, temp = 0, crc = 0;
+	double itmp = 0, temperature = 0;
+	uint8_t nibbles[9];
+	int i = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temperature) != 0) {
+		logprintf(LOG_ERR, "tfa: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	id = (int)round(itmp);
+	if(json_find_number(code, "channel", &itmp) == 0)
+		channel = (int)round(itmp);
+	if(json_find_number(code, "humidity", &itmp) == 0)
+		humidity = (int)round(itmp);
+	if(json_find_number(code, "battery", &itmp) == 0)
+		battery = (int)round(itmp);
+
+	/* tenth of °F with an offset of 90 °F */
+	temp = (int)round(temperature*18)+1220;
+
+	if(id > 255 || id < 0) {
+		logprintf(LOG_ERR, "tfa: invalid id range");
+		return EXIT_FAILURE;
+	} else if(channel > 4 || channel < 1) {
+		logprintf(LOG_ERR, "tfa: invalid channel range");
+		return EXIT_FAILURE;
+	} else if(temp > 4095 || temp < 0) {
+		logprintf(LOG_ERR, "tfa: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity > 100 || humidity < 0) {
+		logprintf(LOG_ERR, "tfa: invalid humidity range");
+		return EXIT_FAILURE;
+	} else {
+		memset(binary, 0, sizeof(binary));
+		decToBinRangeRev(binary, 2, 9, id);
+		decToBinRangeRev(binary, 12, 13, channel-1);
+		decToBinRangeRev(binary, 14, 17, temp & 0xf);
+		decToBinRangeRev(binary, 18, 21, (temp >> 4) & 0xf);
+		decToBinRangeRev(binary, 22, 25, temp >> 8);
+		decToBinRangeRev(binary, 26, 29, humidity & 0xf);
+		decToBinRangeRev(binary, 30, 33, humidity >> 4);
+		binary[35] = !battery;
+
+		binToNibbles(binary, 0, 33, nibbles);
+		crc = crcNibbles(&crc4, nibbles, 34, 0);
+		crc ^= binToDec(binary, 34, 37);
+		decToBinRange(binary, 38, 41, crc);
+
+		createMessage(id, (double)((((temp*10) - 9000 - 3200) * 5) / 9), humidity, (battery != 0), channel);
+		for(i=0;i<42;i++) {
+			if(binary[i] == 1) {
+				createHigh(i*2, i*2+1);
+			} else {
+				createLow(i*2, i*2+1);
+			}
+		}
+		createFooter();
+		tfa->rawlen = MED_RAW_LENGTH;
+	}
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -c --channel=channel\t\tsend on this channel\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+	printf("\t -b --battery=battery\t\tsend this battery state\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -269,7 +368,11 @@ void tfaInit(void) {
 	options_add(&tfa->options, "0", "show-temperature", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 	options_add(&tfa->options, "0", "show-battery", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
+	crcInitRev(&crc4, 0xc, 4);
+
 	tfa->parseCode=&parseCode;
+	tfa->createCode=&createCode;
+	tfa->printHelp=&printHelp;
 	tfa->checkValues=&checkValues;
 	tfa->validate=&validate;
 	tfa->gc=&gc;
@@ -17,6 +17,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/checksum.h"
 #include "tfa2017.h"
 
 #define MIN_PULSE_LENGTH	250
@@ -24,6 +25,8 @@
 #define MIN_RAW_LENGTH		200
 #define MAX_RAW_LENGTH		400
 #define MESSAGE_LENGTH		48
+#define SHORT_PULSE		500
+#define LONG_PULSE		1000
 
 typedef struct settings_t {
 	double id;
@@ -43,6 +46,21 @@ static int validate(void) {
 	return -1;
 }
 
+/* LFSR digest (generator 0x98, key 0x3e) over the first five bytes */
+static int digest(const int *msg) {
+	uint8_t nibbles[10];
+
+	binToNibblesRev(msg, 0, 39, nibbles);
+	return lfsrDigest(nibbles, 10, 0x98, 0x3e) ^ 0x64;
+}
+
+static void createMessage(int channel, double temperature, double humidity) {
+	tfa2017->message = json_mkobject();
+	json_append_member(tfa2017->message, "id", json_mknumber(channel, 0));
+	json_append_member(tfa2017->message, "temperature", json_mknumber(temperature, 2));
+	json_append_member(tfa2017->message, "humidity", json_mknumber(humidity, 2));
+}
+
 static void parseCode(void) {
 	int i = 0, x = 0, short_pulse = 0, prev = 0, long_pulse = 0;
 	int s = 0, start[3], m = 0, binary[MAX_RAW_LENGTH];
@@ -120,8 +138,11 @@ static void parseCode(void) {
 	 */
 	humidity = (double)binToDecRev(msg, 32, 39);
 	/*
-	 * The last byte contains a checksum which is not used here.
+	 * The last byte contains a checksum.
 	 */
+	if(binToDecRev(msg, 40, 47) != digest(msg)) {
+		return;
+	}
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -136,10 +157,7 @@ static void parseCode(void) {
 		return;
 	}
 
-	tfa2017->message = json_mkobject();
-	json_append_member(tfa2017->message, "id", json_mknumber(channel, 0));
-	json_append_member(tfa2017->message, "temperature", json_mknumber(temperature, 2));
-	json_append_member(tfa2017->message, "humidity", json_mknumber(humidity, 2));
+	createMessage(channel, temperature, humidity);
 }
 
 static int checkValues(struct JsonNode *jvalues) {
@@ -204,6 +222,93 @@ static void gc(void) {
 	}
 }
 
+/*
+ * Writes one message behind the preamble of 20 short pulses, a bit equal to
+ * its predecessor is sent as two short pulses and a toggled one as a long pulse.
+ * Stops once pulse e is reached.
+ */
+static int createRepeat(int *msg, int s, int e) {
+	int pulses[20+2+MESSAGE_LENGTH*2+1];
+	int x = 0, n = 0, prev = 1;
+
+	for(x=0;x<20;x++) {
+		pulses[n++]=SHORT_PULSE;
+	}
+	pulses[n++]=LONG_PULSE;
+	pulses[n++]=LONG_PULSE;
+	for(x=0;x<MESSAGE_LENGTH;x++) {
+		if(msg[x] == prev) {
+			pulses[n++]=SHORT_PULSE;
+			pulses[n++]=SHORT_PULSE;
+		} else {
+			pulses[n++]=LONG_PULSE;
+		}
+		prev = msg[x];
+	}
+	pulses[n++]=LONG_PULSE;
+
+	for(x=0;x<n && s<e;x++) {
+		tfa2017->raw[s++]=pulses[x];
+	}
+	return s;
+}
+
+static int createCode(struct JsonNode *code) {
+	int msg[MESSAGE_LENGTH];
+	int channel = 0, temperature = 0, humidity = 0;
+	int s = 0;
+	double itmp = 0, temp = 0;
+
+	if(json_find_number(code, "id", &itmp) != 0 || json_find_number(code, "temperature", &temp) != 0) {
+		logprintf(LOG_ERR, "tfa2017: insufficient number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	channel = (int)round(itmp);
+	temperature = (int)round((temp+40.)*18.);
+	if(json_find_number(code, "humidity", &itmp) == 0)
+		humidity = (int)round(itmp);
+
+	if(channel < 1 || channel > 8) {
+		logprintf(LOG_ERR, "tfa2017: invalid id range");
+		return EXIT_FAILURE;
+	} else if(temperature < 0 || temperature > 4095) {
+		logprintf(LOG_ERR, "tfa2017: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(humidity < 0 || humidity > 100) {
+		logprintf(LOG_ERR, "tfa2017: invalid humidity range");
+		return EXIT_FAILURE;
+	}
+
+	memset(msg, 0, sizeof(msg));
+	decToBinRangeRev(msg, 0, 7, 0x45);
+	decToBinRangeRev(msg, 17, 19, channel-1);
+	decToBinRangeRev(msg, 20, 31, temperature);
+	decToBinRangeRev(msg, 32, 39, humidity);
+
+	decToBinRangeRev(msg, 40, 47, digest(msg));
+
+	createMessage(channel, (double)temperature/18.-40., humidity);
+
+	/*
+	 * Three repeats do not fit the 8 bit rawlen, parseCode() only needs
+	 * two identical ones so the third is cut off at MIN_RAW_LENGTH.
+	 */
+	s = createRepeat(msg, 0, MAX_RAW_LENGTH);
+	s = createRepeat(msg, s, MAX_RAW_LENGTH);
+	s = createRepeat(msg, s, MIN_RAW_LENGTH-1);
+	tfa2017->raw[s++]=(MIN_PULSE_LENGTH*PULSE_DIV);
+	tfa2017->rawlen = s;
+
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor on this channel\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -231,6 +336,8 @@ void tfa2017Init(void) {
 	options_add(&tfa2017->options, "0", "show-temperature", OPTION_HAS_VALUE, GUI_SETTING, JSON_NUMBER, (void *)1, "^[10]{1}$");
 
 	tfa2017->parseCode=&parseCode;
+	tfa2017->createCode=&createCode;
+	tfa2017->printHelp=&printHelp;
 	tfa2017->checkValues=&checkValues;
 	tfa2017->validate=&validate;
 	tfa2017->gc=&gc;
@@ -29,6 +29,7 @@
 #include "../../core/log.h"
 #include "../protocol.h"
 #include "../../core/binary.h"
+#include "../../core/checksum.h"
 #include "../../core/gc.h"
 #include "tfa30.h"
 //
@@ -67,9 +68,7 @@ static void parseCode(void) {
 	int i = 0, x = 0, type = 0, id = 0, binary[MAX_RAW_LENGTH/2];
 	double temp_offset = 0.0, humi_offset = 0.0;
 	double humidity = 0.0, temperature = 0.0;
-	int n0 = 0, n1 = 0, n2 = 0, n3 = 0, n3b = 0;
-	int n4 = 0, n5 = 0, n6 = 0, n7 = 0, n8 = 0;
-	int n9 = 0, n10 = 0;
+	uint8_t n[11];
 	int y = 0;
 	int checksum = 1;
 
@@ -92,20 +91,9 @@ static void parseCode(void) {
 		}
 	}
 
- 	n10=binToDecRev(binary, 40, 43);
- 	n9=binToDecRev(binary, 36, 39);
-	n8=binToDecRev(binary, 32, 35);
-	n7=binToDecRev(binary, 28, 31);
-	n6=binToDecRev(binary, 24, 27);
-	n5=binToDecRev(binary, 20, 23);
-	n4=binToDecRev(binary, 16, 19);
-	n3b=binToDecRev(binary, 12, 18);
-	n3=binToDecRev(binary, 12, 15);
-	n2=binToDecRev(binary, 8, 11);
-	n1=binToDecRev(binary, 4, 7);
-	n0=binToDecRev(binary, 0, 3);
-
-	id = n3b;
+	binToNibblesRev(binary, 0, 43, n);
+
+	id = binToDecRev(binary, 12, 18);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -118,18 +106,18 @@ static void parseCode(void) {
 	}
 
 	// Temp
-	if((n1 == 0xa) & (n2 == 0x0)) {
+	if((n[1] == 0xa) & (n[2] == 0x0)) {
 		type = 0x1;
-		checksum = (n0+n1+n2+n3+n4+n5+n6+n7+n8+n9) & 0xf;
-		if(n10 != checksum) {
+		checksum = addNibbles(n, 10) & 0xf;
+		if(n[10] != checksum) {
 			type=0x5;
 			return;
 		}
 	// Hum
-	} else if((n1 == 0xa) & (n2 == 0xe)) {
+	} else if((n[1] == 0xa) & (n[2] == 0xe)) {
 		type = 0x2;
-		checksum = (n0+n1+n2+n3+n4+n5+n6+n7+n8+n9) & 0xf;
-		if(n10 != checksum){
+		checksum = addNibbles(n, 10) & 0xf;
+		if(n[10] != checksum){
 			type=0x5;
 			return;
 		}
@@ -142,14 +130,14 @@ static void parseCode(void) {
 	tfa30->message = json_mkobject();
 	switch(type) {
 		case 1:
-			temperature = (double)(n5-5)*10 + n6 + n7/10.0;
+			temperature = (double)(n[5]-5)*10 + n[6] + n[7]/10.0;
 			temperature += temp_offset;
 
 			json_append_member(tfa30->message, "id", json_mknumber(id, 0));
 			json_append_member(tfa30->message, "temperature", json_mknumber(temperature, 1));
 		break;
 		case 2:
-			humidity = (double)(n5)*10 + n6;
+			humidity = (double)(n[5])*10 + n[6];
 			humidity += humi_offset;
 
 			json_append_member(tfa30->message, "id", json_mknumber(id, 0));
@@ -225,6 +213,106 @@ static void gc(void) {
 	}
 }
 
+static void createLow(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tfa30->raw[i]=(ZERO_PULSE);
+		tfa30->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createHigh(int s, int e) {
+	int i;
+
+	for(i=s;i<=e;i+=2) {
+		tfa30->raw[i]=(ONE_PULSE);
+		tfa30->raw[i+1]=(AVG_PULSE_LENGTH);
+	}
+}
+
+static void createFooter(void) {
+	tfa30->raw[RAW_LENGTH-1]=(PULSE_DIV*AVG_PULSE_LENGTH);
+}
+
+static int createCode(struct JsonNode *code) {
+	int binary[MAX_RAW_LENGTH/2];
+	int id = 0, value = 0;
+	double itmp = 0, temperature = 0, humidity = 0;
+	uint8_t n[11];
+	int type = 0, i = 0;
+
+	if(json_find_number(code, "id", &itmp) == 0)
+		id = (int)round(itmp);
+	if(json_find_number(code, "temperature", &temperature) == 0) {
+		type = 0x1;
+		/* BCD of tenth of degrees with an offset of 50 °C */
+		value = (int)round((temperature+50)*10);
+	} else if(json_find_number(code, "humidity", &humidity) == 0) {
+		type = 0x2;
+		value = (int)round(humidity)*10;
+	}
+
+	if(json_find_member(code, "id") == NULL || type == 0) {
+		logprintf(LOG_ERR, "tfa30: insufficient number of arguments");
+		return EXIT_FAILURE;
+	} else if(id > 127 || id < 0) {
+		logprintf(LOG_ERR, "tfa30: invalid id range");
+		return EXIT_FAILURE;
+	} else if(type == 0x1 && (value > 999 || value < 0)) {
+		logprintf(LOG_ERR, "tfa30: invalid temperature range");
+		return EXIT_FAILURE;
+	} else if(type == 0x2 && (value > 990 || value < 0)) {
+		logprintf(LOG_ERR, "tfa30: invalid humidity range");
+		return EXIT_FAILURE;
+	}
+
+	memset(n, 0, sizeof(n));
+	n[1] = 0xa;
+	n[2] = (type == 0x1) ? 0x0 : 0xe;
+	n[5] = (uint8_t)(value/100);
+	n[6] = (uint8_t)((value/10)%10);
+	n[7] = (uint8_t)(value%10);
+	/* the integer part is repeated */
+	n[8] = n[5];
+	n[9] = n[6];
+
+	memset(binary, 0, sizeof(binary));
+	for(i=0;i<10;i++) {
+		decToBinRangeRev(binary, i*4, i*4+3, n[i]);
+	}
+	decToBinRangeRev(binary, 12, 18, id);
+	binToNibblesRev(binary, 0, 39, n);
+	n[10] = addNibbles(n, 10) & 0xf;
+	decToBinRangeRev(binary, 40, 43, n[10]);
+
+	tfa30->message = json_mkobject();
+	json_append_member(tfa30->message, "id", json_mknumber(id, 0));
+	if(type == 0x1) {
+		json_append_member(tfa30->message, "temperature", json_mknumber((double)value/10-50, 1));
+	} else {
+		json_append_member(tfa30->message, "humidity", json_mknumber((double)value/10, 1));
+	}
+
+	for(i=0;i<44;i++) {
+		if(binary[i] == 1) {
+			createHigh(i*2, i*2+1);
+		} else {
+			createLow(i*2, i*2+1);
+		}
+	}
+	createFooter();
+	tfa30->rawlen = RAW_LENGTH;
+
+	return EXIT_SUCCESS;
+}
+
+static void printHelp(void) {
+	printf("\t -i --id=id\t\t\tsend as the sensor with this id\n");
+	printf("\t -t --temperature=temperature\tsend this temperature\n");
+	printf("\t -h --humidity=humidity\t\tsend this humidity\n");
+}
+
 #if !defined(MODULE) && !defined(_WIN32)
 __attribute__((weak))
 #endif
@@ -254,6 +342,8 @@ void tfa30Init(void) {
 
 
 	tfa30->parseCode=&parseCode;
+	tfa30->createCode=&createCode;
+	tfa30->printHelp=&printHelp;
 	tfa30->checkValues=&checkValues;
 	tfa30->validate=&validate;
 	tfa30->gc=&gc;
@@ -36,7 +36,7 @@
 #define AVG_PULSE_LENGTH	150
 #define RAW_LENGTH				68
 
-static char letters[18] = {"MNOPCDABEFGHKL IJ"};
+static const char letters[18] PROGMEM = {"MNOPCDABEFGHKL IJ"};
 
 static int validate(void) {
 	if(x10->rawlen == RAW_LENGTH) {
@@ -76,7 +76,7 @@ static void parseCode(void) {
 	}
 
 	char id[3];
-	int l = letters[binToDecRev(binary, 0, 3)];
+	int l = pgm_read_byte(&letters[binToDecRev(binary, 0, 3)]);
 	int s = binary[18];
 	int i = 1;
 	int c1 = (binToDec(binary, 0, 7)+binToDec(binary, 8, 15));
@@ -124,7 +124,7 @@ static void createLetter(int l) {
 	int i=0, x=0, y = 0;
 
 	for(i=0;i<17;i++) {
-		if((int)letters[i] == l) {
+		if((int)pgm_read_byte(&letters[i]) == l) {
 			length = decToBinRev(i, binary);
 			for(x=0;x<=length;x++) {
 				if(binary[x]==1) {
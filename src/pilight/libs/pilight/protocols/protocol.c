@@ -68,7 +68,12 @@ void protocol_register(protocol_t **proto) {
   (*proto)->raw = NULL;
 
   /* Arduino special, compare repeated messages*/
-  (*proto)->old_content = NULL;
+  (*proto)->old_message = NULL;
+
+#if PROTOCOL_STATS
+  /* Arduino special, decode statistics */
+  memset(&(*proto)->stats, 0, sizeof((*proto)->stats));
+#endif
 
   struct protocols_t *pnode = MALLOC(sizeof(struct protocols_t));
   if(pnode == NULL) {
@@ -80,6 +85,6 @@ void protocol_register(protocol_t **proto) {
   pilight_protocols = pnode;
 }
 
-void protocol_set_id(protocol_t *proto, char *id) {
+void protocol_set_id_P(protocol_t *proto, const char *id) {
   proto->id = id;
 }
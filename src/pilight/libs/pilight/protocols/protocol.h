@@ -60,8 +60,28 @@ typedef enum {
   ALARM
 } devtype_t;
 
+/*
+ * ESPiLight special, set PROTOCOL_STATS to 1 to count decode statistics per
+ * protocol, see ESPiLight::protocolStats().
+ */
+#ifndef PROTOCOL_STATS
+#define PROTOCOL_STATS 0
+#endif
+
+#if PROTOCOL_STATS
+typedef struct protocol_stats_t {
+  uint32_t validate_calls;
+  uint32_t validate_accepts;
+  uint32_t messages;
+  uint64_t validate_cycles;
+  uint32_t validate_max_cycles;
+  uint64_t parse_cycles;
+  uint32_t parse_max_cycles;
+} protocol_stats_t;
+#endif
+
 typedef struct protocol_t {
-  char *id;
+  const char *id; /* in flash, see protocol_set_id() */
   uint8_t rawlen;
   uint8_t minrawlen;
   uint8_t maxrawlen;
@@ -98,8 +118,13 @@ typedef struct protocol_t {
   void (*gc)(void);
   //void (*threadGC)(void);
 
-  /* ESPiLight special, used to compare repeated messages*/
-  char *old_content;
+  /* ESPiLight special, last reported message, to compare repeated messages */
+  JsonNode *old_message;
+
+#if PROTOCOL_STATS
+  /* ESPiLight special, decode statistics */
+  protocol_stats_t stats;
+#endif
 } protocol_t;
 
 typedef struct protocols_t {
@@ -111,7 +136,9 @@ typedef struct protocols_t {
 extern struct protocols_t *pilight_protocols;
 
 void protocol_init(void);
-void protocol_set_id(protocol_t *proto, char *id);
+void protocol_set_id_P(protocol_t *proto, const char *id);
+/* ESPiLight special, the protocol ids are literals, keep them in flash */
+#define protocol_set_id(proto, id) protocol_set_id_P(proto, PSTR(id))
 void protocol_register(protocol_t **proto);
 #define protocol_device_add(proto, id, desc)
 
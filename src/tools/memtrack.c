@@ -0,0 +1,101 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#include "memtrack.h"
+
+#if MEMORY_STATS
+
+#include <stdlib.h>
+#include <string.h>
+
+/* every block is prefixed with its size, aligned like malloc() */
+typedef union memtrack_header_t {
+  size_t size;
+  double align_double;
+  long long align_long;
+  void *align_ptr;
+} memtrack_header_t;
+
+memtrack_stats_t memtrack_stats;
+
+static void *memtrack_account(memtrack_header_t *header, size_t size) {
+  if (header == NULL) {
+    return NULL;
+  }
+  header->size = size;
+  memtrack_stats.allocations++;
+  memtrack_stats.bytes += size;
+  memtrack_stats.current += size;
+  if (memtrack_stats.current > memtrack_stats.peak) {
+    memtrack_stats.peak = memtrack_stats.current;
+  }
+  return header + 1;
+}
+
+void *memtrack_malloc(size_t size) {
+  return memtrack_account(malloc(sizeof(memtrack_header_t) + size), size);
+}
+
+void *memtrack_calloc(size_t count, size_t size) {
+  void *ptr = memtrack_malloc(count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void *memtrack_realloc(void *ptr, size_t size) {
+  if (ptr == NULL) {
+    return memtrack_malloc(size);
+  }
+  if (size == 0) {
+    memtrack_free(ptr);
+    return NULL;
+  }
+  memtrack_header_t *header = (memtrack_header_t *)ptr - 1;
+  const size_t old_size = header->size;
+  header = realloc(header, sizeof(memtrack_header_t) + size);
+  if (header == NULL) {
+    return NULL;
+  }
+  /* counted as free of the old and allocation of the new block */
+  memtrack_stats.frees++;
+  memtrack_stats.current -= old_size;
+  return memtrack_account(header, size);
+}
+
+char *memtrack_strdup(const char *str) {
+  const size_t size = strlen(str) + 1;
+  char *copy = memtrack_malloc(size);
+  if (copy != NULL) {
+    memcpy(copy, str, size);
+  }
+  return copy;
+}
+
+void memtrack_free(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  memtrack_header_t *header = (memtrack_header_t *)ptr - 1;
+  memtrack_stats.frees++;
+  memtrack_stats.current -= header->size;
+  free(header);
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+  ESPiLight - pilight 433.92 MHz protocols library for Arduino
+  Copyright (c) 2016 Puuu.  All right reserved.
+
+  Project home: https://github.com/puuu/espilight/
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _MEMTRACK_H_
+#define _MEMTRACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Set MEMORY_STATS to 1 to count the heap allocations of the pilight code
+ * (MALLOC, CALLOC, REALLOC, STRDUP and FREE of mem.h).
+ */
+#ifndef MEMORY_STATS
+#define MEMORY_STATS 0
+#endif
+
+typedef struct memtrack_stats_t {
+  uint32_t allocations;
+  uint32_t frees;
+  uint32_t bytes;   /* bytes allocated */
+  uint32_t current; /* bytes in use */
+  uint32_t peak;    /* maximum of current */
+} memtrack_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern memtrack_stats_t memtrack_stats;
+
+void *memtrack_malloc(size_t size);
+void *memtrack_calloc(size_t count, size_t size);
+void *memtrack_realloc(void *ptr, size_t size);
+char *memtrack_strdup(const char *str);
+void memtrack_free(void *ptr);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //_MEMTRACK_H_
+
+/* override the allocation macros, if included by mem.h */
+#if MEMORY_STATS && defined(_MEM_H_) && !defined(_MEMTRACK_MEM_H_)
+#define _MEMTRACK_MEM_H_
+#undef MALLOC
+#undef REALLOC
+#undef CALLOC
+#undef STRDUP
+#undef FREE
+#define MALLOC memtrack_malloc
+#define REALLOC memtrack_realloc
+#define CALLOC memtrack_calloc
+#define STRDUP memtrack_strdup
+#define FREE(a) memtrack_free((void *)(a)), (a) = NULL
+#endif